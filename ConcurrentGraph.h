@@ -0,0 +1,248 @@
+#pragma once
+
+#include "Graph.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+
+// Graph shared between many reader threads and a writer. Readers pin an immutable,
+// versioned snapshot without taking any lock; writers queue mutations and publish them
+// as one new version. Old versions are reclaimed once no reader announced an epoch
+// from before they were replaced (epoch based reclamation). Only READER_SLOTS readers
+// can be active lock free; beyond that read() announces in an overflow slot under a
+// mutex, which the writer also takes while reclaiming.
+//
+// A new version copies the vertex map of the previous one, O(V), and shares every
+// neighbour map with it except those the batch modifies (see Shared_Adjacency). Batch
+// updates so that this copy is amortised over many changes.
+template<typename Datatype>
+class Concurrent_Graph
+{
+private:
+	const static uint64_t IDLE_EPOCH = UINT64_MAX;
+	const static size_t READER_SLOTS = 128;
+
+	struct Version
+	{
+		Graph<Datatype> graph;
+		uint64_t number;
+	};
+
+	struct alignas(64) Reader_Slot
+	{
+		atomic<uint64_t> epoch{ IDLE_EPOCH };
+	};
+
+public:
+	// Keeps one snapshot alive while in scope. Holding readers for long delays the
+	// reclamation of every version published after the pinned one.
+	class Reader
+	{
+	public:
+		Reader(Reader&&);
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+		~Reader();
+
+		const Graph<Datatype>& operator*() const { return snapshot->graph; }
+		const Graph<Datatype>* operator->() const { return &snapshot->graph; }
+		uint64_t version() const { return snapshot->number; }
+
+	private:
+		friend class Concurrent_Graph;
+		Reader(Reader_Slot*, const Version*);
+
+		Reader_Slot* slot;
+		const Version* snapshot;
+	};
+
+public:
+	Concurrent_Graph();
+	Concurrent_Graph(const Graph<Datatype>&);
+	Concurrent_Graph(const Concurrent_Graph&) = delete;
+	Concurrent_Graph& operator=(const Concurrent_Graph&) = delete;
+	~Concurrent_Graph();
+
+	Reader read() const;
+	uint64_t version() const;
+
+	void insert_node(const Datatype&);
+	void insert_edge(const Edge<Datatype>&);
+	void remove_node(const Datatype&);
+	void remove_edge(const Edge<Datatype>&);
+	void change_weight(const Edge<Datatype>&, double);
+
+	uint64_t publish();
+	template<typename Function>
+	uint64_t update(Function);
+
+private:
+	void enqueue(function<void(Graph<Datatype>&)>&&);
+	void reclaim();
+
+private:
+	atomic<const Version*> current;
+	atomic<uint64_t> epoch{ 0 };
+	mutable Reader_Slot slots[READER_SLOTS];
+	mutable mutex overflow_mutex;
+	mutable vector<unique_ptr<Reader_Slot> > overflow_slots;
+
+	mutex writer_mutex;
+	vector<function<void(Graph<Datatype>&)> > pending_changes;
+	vector<pair<uint64_t, const Version*> > retired;
+};
+
+
+template<typename Datatype>
+Concurrent_Graph<Datatype> ::Reader ::Reader(Reader_Slot* slot, const Version* snapshot) {
+	this->slot = slot;
+	this->snapshot = snapshot;
+}
+
+template<typename Datatype>
+Concurrent_Graph<Datatype> ::Reader ::Reader(Reader&& other) {
+	slot = other.slot;
+	snapshot = other.snapshot;
+	other.slot = nullptr;
+}
+
+template<typename Datatype>
+Concurrent_Graph<Datatype> ::Reader ::~Reader() {
+	if (slot != nullptr)
+		slot->epoch.store(IDLE_EPOCH, memory_order_release);
+}
+
+template<typename Datatype>
+Concurrent_Graph<Datatype> ::Concurrent_Graph() : current(new Version{ Graph<Datatype>(), 0 }) {}
+
+template<typename Datatype>
+Concurrent_Graph<Datatype> ::Concurrent_Graph(const Graph<Datatype>& graph) : current(new Version{ graph, 0 }) {}
+
+// No reader may outlive the graph it reads from.
+template<typename Datatype>
+Concurrent_Graph<Datatype> ::~Concurrent_Graph() {
+	for (auto& [tag, version] : retired)
+		delete version;
+	delete current.load();
+}
+
+// Announces the current epoch in a free slot and only then loads the version, so a
+// writer that replaces the version afterwards is guaranteed to see the announcement.
+template<typename Datatype>
+typename Concurrent_Graph<Datatype> ::Reader Concurrent_Graph<Datatype> ::read() const {
+	size_t start = hash<thread::id>()(this_thread::get_id());
+	for (size_t attempt = 0; attempt < READER_SLOTS; attempt++) {
+		Reader_Slot& slot = slots[(start + attempt) % READER_SLOTS];
+		uint64_t idle = IDLE_EPOCH;
+		if (slot.epoch.load(memory_order_relaxed) == IDLE_EPOCH and slot.epoch.compare_exchange_strong(idle, epoch.load()))
+			return Reader(&slot, current.load());
+	}
+
+	// Every slot is taken: reuse an idle overflow slot or add one. Overflow slots live
+	// until the graph is destroyed, so the pointer held by the Reader stays valid.
+	lock_guard<mutex> lock(overflow_mutex);
+	for (unique_ptr<Reader_Slot>& slot : overflow_slots) {
+		uint64_t idle = IDLE_EPOCH;
+		if (slot->epoch.compare_exchange_strong(idle, epoch.load()))
+			return Reader(slot.get(), current.load());
+	}
+	overflow_slots.emplace_back(new Reader_Slot());
+	overflow_slots.back()->epoch.store(epoch.load());
+	return Reader(overflow_slots.back().get(), current.load());
+}
+
+template<typename Datatype>
+uint64_t Concurrent_Graph<Datatype> ::version() const { return read().version(); }
+
+template<typename Datatype>
+void Concurrent_Graph<Datatype> ::insert_node(const Datatype& node) {
+	enqueue([node](Graph<Datatype>& graph) { graph.insert_node(node); });
+}
+
+template<typename Datatype>
+void Concurrent_Graph<Datatype> ::insert_edge(const Edge<Datatype>& edge) {
+	enqueue([edge](Graph<Datatype>& graph) { graph.insert_edge(edge); });
+}
+
+template<typename Datatype>
+void Concurrent_Graph<Datatype> ::remove_node(const Datatype& node) {
+	enqueue([node](Graph<Datatype>& graph) { graph.remove_node(node); });
+}
+
+template<typename Datatype>
+void Concurrent_Graph<Datatype> ::remove_edge(const Edge<Datatype>& edge) {
+	enqueue([edge](Graph<Datatype>& graph) { graph.remove_edge(edge); });
+}
+
+template<typename Datatype>
+void Concurrent_Graph<Datatype> ::change_weight(const Edge<Datatype>& edge, double weight) {
+	enqueue([edge, weight](Graph<Datatype>& graph) { graph.change_weight(edge, weight); });
+}
+
+// Returns the current version without copying anything when no change is queued.
+template<typename Datatype>
+uint64_t Concurrent_Graph<Datatype> ::publish() {
+	{
+		lock_guard<mutex> lock(writer_mutex);
+		if (pending_changes.empty())
+			return current.load()->number;
+	}
+	return update([](Graph<Datatype>&) {});
+}
+
+// Applies the queued changes and then `mutate` to a private copy of the current version
+// and publishes the result. The batch is all or nothing: if any change throws, nothing
+// is published, the queue is discarded and the exception is rethrown.
+template<typename Datatype>
+template<typename Function>
+uint64_t Concurrent_Graph<Datatype> ::update(Function mutate) {
+	lock_guard<mutex> lock(writer_mutex);
+	const Version* previous = current.load();
+	Version* next = new Version{ previous->graph, previous->number + 1 };
+	try {
+		for (function<void(Graph<Datatype>&)>& change : pending_changes)
+			change(next->graph);
+		mutate(next->graph);
+	}
+	catch (...) {
+		delete next;
+		pending_changes.clear();
+		throw;
+	}
+	pending_changes.clear();
+
+	current.store(next);
+	retired.emplace_back(epoch.fetch_add(1) + 1, previous);
+	reclaim();
+	return next->number;
+}
+
+template<typename Datatype>
+void Concurrent_Graph<Datatype> ::enqueue(function<void(Graph<Datatype>&)>&& change) {
+	lock_guard<mutex> lock(writer_mutex);
+	pending_changes.push_back(move(change));
+}
+
+// A version retired with tag t can only be held by readers that announced an epoch
+// below t. Caller holds writer_mutex.
+template<typename Datatype>
+void Concurrent_Graph<Datatype> ::reclaim() {
+	uint64_t oldest = IDLE_EPOCH;
+	for (Reader_Slot& slot : slots)
+		oldest = min(oldest, slot.epoch.load());
+	{
+		lock_guard<mutex> lock(overflow_mutex);
+		for (unique_ptr<Reader_Slot>& slot : overflow_slots)
+			oldest = min(oldest, slot->epoch.load());
+	}
+
+	size_t kept = 0;
+	for (auto& [tag, version] : retired) {
+		if (tag <= oldest)
+			delete version;
+		else
+			retired[kept++] = { tag, version };
+	}
+	retired.resize(kept);
+}
@@ -4,6 +4,16 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <stdexcept>
+#include <tuple>
+#include <memory>
+#include <cstdint>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <algorithm>
+#include "Instrument.h"
+#include "Parallel.h"
 using namespace std;
 
 
@@ -30,6 +40,73 @@ private:
 };
 
 
+// Compressed sparse row view of an undirected graph. Vertex i is nodes()[i] and its
+// neighbours are targets()[offsets()[i] .. offsets()[i + 1]); every undirected edge
+// is stored once per direction. The arrays are owned through a shared storage handle,
+// which is either a set of vectors or a memory mapped file (see GraphIO.h).
+template<typename Datatype>
+class Csr_Graph
+{
+public:
+	Csr_Graph() {}
+	Csr_Graph(vector<Datatype>&&, vector<uint64_t>&&, vector<uint32_t>&&, vector<double>&&);
+	Csr_Graph(shared_ptr<const void>, size_t, const Datatype*, const uint64_t*, const uint32_t*, const double*);
+
+	size_t node_count() const { return nodes_size; }
+	size_t edge_count() const { return nodes_size == 0 ? 0 : (size_t)offset_data[nodes_size]; }
+	size_t degree(uint32_t node) const { return (size_t)(offset_data[node + 1] - offset_data[node]); }
+	uint32_t index_of(const Datatype&) const;
+
+	const Datatype* nodes() const { return node_data; }
+	const uint64_t* offsets() const { return offset_data; }
+	const uint32_t* targets() const { return target_data; }
+	const double* weights() const { return weight_data; }
+
+private:
+	shared_ptr<const void> storage;
+	size_t nodes_size = 0;
+	bool sorted_nodes = true;
+	const Datatype* node_data = nullptr;
+	const uint64_t* offset_data = nullptr;
+	const uint32_t* target_data = nullptr;
+	const double* weight_data = nullptr;
+};
+
+
+struct Insert_Summary
+{
+	size_t inserted = 0;
+	size_t duplicates = 0;
+	size_t existing = 0;
+	size_t missing = 0;
+	size_t created_nodes = 0;
+};
+
+
+template<typename Datatype>
+struct Spanning_Forest
+{
+	vector<Edge<Datatype> > edges;
+	double total_weight = 0;
+};
+
+
+// Neighbour map of one vertex, shared between copies of a Graph until one of them
+// modifies it. Copying a graph therefore copies the vertex map but not the adjacency,
+// which is what lets Concurrent_Graph publish a version per batch cheaply. A null
+// pointer stands for an empty map so that isolated vertices allocate nothing.
+template<typename Datatype>
+class Shared_Adjacency
+{
+public:
+	const map<Datatype, double>& neighbours() const;
+	map<Datatype, double>& modify();
+
+private:
+	shared_ptr<map<Datatype, double> > adjacent;
+};
+
+
 template<typename Datatype>
 class Graph
 {
@@ -39,25 +116,100 @@ public:
 	void remove_node(const Datatype&);
 	void remove_edge(const Edge<Datatype>&);
 	void change_weight(const Edge<Datatype>&, double);
+
+	template<typename Range>
+	Insert_Summary insert_edges(const Range&, bool create_nodes = false);
+	template<typename Range>
+	Insert_Summary build_from_edge_list(const Range&);
 	
-	int total_components();
+	int total_components() const;
+	Spanning_Forest<Datatype> kruskal() const;
+	Spanning_Forest<Datatype> boruvka() const;
+	Spanning_Forest<Datatype> minimum_spanning_forest() const;
+	Csr_Graph<Datatype> to_csr() const;
 
-	bool has_edge(const Datatype&, const Datatype&);
-	bool has_connection(const Datatype&, const Datatype&);
+	bool has_edge(const Datatype&, const Datatype&) const;
+	bool has_connection(const Datatype&, const Datatype&) const;
 
 private:
-	void dfs_util(const Datatype&, map<Datatype, bool>&);
+	bool has_nodes(const Datatype&, const Datatype&) const;
+	void dfs_util(const Datatype&, map<Datatype, bool>&) const;
+
+	vector<tuple<double, uint32_t, uint32_t> > indexed_edges(vector<const Datatype*>&) const;
+	static uint32_t find_root(vector<uint32_t>&, uint32_t);
+	static bool unite(vector<uint32_t>&, vector<uint32_t>&, uint32_t, uint32_t);
+
+	template<typename Type>
+	static void parallel_sort(vector<Type>&);
 
 private:
-	map<Datatype, map<Datatype, double> > graph;
+	map<Datatype, Shared_Adjacency<Datatype> > graph;
+	const static size_t PARALLEL_THRESHOLD = 1 << 16;
 };
 
 
+template<typename Datatype>
+Csr_Graph<Datatype> ::Csr_Graph(vector<Datatype>&& nodes, vector<uint64_t>&& offsets, vector<uint32_t>&& targets, vector<double>&& weights) {
+	auto arrays = make_shared<tuple<vector<Datatype>, vector<uint64_t>, vector<uint32_t>, vector<double> > >(
+		move(nodes), move(offsets), move(targets), move(weights));
+	nodes_size = get<0>(*arrays).size();
+	node_data = get<0>(*arrays).data();
+	offset_data = get<1>(*arrays).data();
+	target_data = get<2>(*arrays).data();
+	weight_data = get<3>(*arrays).data();
+	sorted_nodes = is_sorted(node_data, node_data + nodes_size);
+	storage = move(arrays);
+}
+
+template<typename Datatype>
+Csr_Graph<Datatype> ::Csr_Graph(shared_ptr<const void> storage, size_t nodes_size, const Datatype* nodes,
+	const uint64_t* offsets, const uint32_t* targets, const double* weights) {
+	this->storage = move(storage);
+	this->nodes_size = nodes_size;
+	node_data = nodes;
+	offset_data = offsets;
+	target_data = targets;
+	weight_data = weights;
+	sorted_nodes = is_sorted(node_data, node_data + nodes_size);
+}
+
+template<typename Datatype>
+uint32_t Csr_Graph<Datatype> ::index_of(const Datatype& node) const {
+	const Datatype* found = sorted_nodes ? lower_bound(node_data, node_data + nodes_size, node)
+		: find(node_data, node_data + nodes_size, node);
+	if (found == node_data + nodes_size or node < *found or *found < node)
+		throw runtime_error("Node does not exist in graph");
+	return (uint32_t)(found - node_data);
+}
+
+
+template<typename Datatype>
+const map<Datatype, double>& Shared_Adjacency<Datatype> ::neighbours() const {
+	static const map<Datatype, double> empty;
+	return adjacent ? *adjacent : empty;
+}
+
+// Clones the map unless this copy is its only owner. Other owners release their copy
+// with an acq_rel decrement; the acquire fence orders their last reads before our writes.
+template<typename Datatype>
+map<Datatype, double>& Shared_Adjacency<Datatype> ::modify() {
+	if (!adjacent)
+		adjacent = make_shared<map<Datatype, double> >();
+	else if (adjacent.use_count() > 1)
+		adjacent = make_shared<map<Datatype, double> >(*adjacent);
+	else
+		atomic_thread_fence(memory_order_acquire);
+	return *adjacent;
+}
+
+
 template<typename Datatype>
 void Graph<Datatype> ::insert_node(const Datatype& node) {
+	CPPLIB_COUNT(graph_lookups, 1);
 	if (graph.find(node) != graph.end())
-		throw exception("Node already exist in graph");
-	graph[node] = map<Datatype, double>();
+		throw runtime_error("Node already exist in graph");
+	CPPLIB_COUNT(graph_lookups, 1);
+	graph[node] = Shared_Adjacency<Datatype>();
 }
 
 template<typename Datatype>
@@ -66,24 +218,29 @@ void Graph<Datatype> ::insert_edge(const Edge<Datatype>& edge) {
 	Datatype second = edge.getSecond();
 	double weight = edge.getWeight();
 
-	if (graph.find(first) == graph.end() or graph.find(second) == graph.end())
-		throw exception("Respected nodes of edge do not exist in the graph");
+	if (!has_nodes(first, second))
+		throw runtime_error("Respected nodes of edge do not exist in the graph");
 
-	const map<Datatype, double>& firstMap = graph[first];
+	CPPLIB_COUNT(graph_lookups, 2);
+	const map<Datatype, double>& firstMap = graph[first].neighbours();
 	if (firstMap.find(second) != firstMap.end())
-		throw exception("Edge already exists");
+		throw runtime_error("Edge already exists");
 
-	graph[first][second] = weight;
-	graph[second][first] = weight;
+	CPPLIB_COUNT(graph_lookups, 4);
+	graph[first].modify()[second] = weight;
+	graph[second].modify()[first] = weight;
 }
 
 template<typename Datatype>
 void Graph<Datatype> ::remove_node(const Datatype& node) {
+	CPPLIB_COUNT(graph_lookups, 1);
 	if (graph.find(node) == graph.end())
-		throw exception("Node does not exist in graph");
+		throw runtime_error("Node does not exist in graph");
 
-	for (auto& [first, second] : graph[node])
-		graph[first].erase(node);
+	Shared_Adjacency<Datatype> adjacent = graph[node];
+	CPPLIB_COUNT(graph_lookups, 2 + 2 * adjacent.neighbours().size());
+	for (auto& [first, second] : adjacent.neighbours())
+		graph[first].modify().erase(node);
 
 	graph.erase(node);
 }
@@ -93,15 +250,17 @@ void Graph<Datatype> ::remove_edge(const Edge<Datatype>& edge) {
 	Datatype first = edge.getFirst();
 	Datatype second = edge.getSecond();
 
-	if (graph.find(first) == graph.end() or graph.find(second) == graph.end())
-		throw exception("Respected nodes of edge do not exist in the graph");
+	if (!has_nodes(first, second))
+		throw runtime_error("Respected nodes of edge do not exist in the graph");
 
-	map<Datatype, double>& firstMap = graph[first];
+	CPPLIB_COUNT(graph_lookups, 2);
+	const map<Datatype, double>& firstMap = graph[first].neighbours();
 	if (firstMap.find(second) == firstMap.end())
-		throw exception("Given edge not found in the graph");
+		throw runtime_error("Given edge not found in the graph");
 
-	firstMap.erase(second);
-	graph[second].erase(first);
+	CPPLIB_COUNT(graph_lookups, 4);
+	graph[first].modify().erase(second);
+	graph[second].modify().erase(first);
 }
 
 template<typename Datatype>
@@ -109,19 +268,100 @@ void Graph<Datatype> ::change_weight(const Edge<Datatype>& edge, double weight)
 	Datatype first = edge.getFirst();
 	Datatype second = edge.getSecond();
 
-	if (graph.find(first) == graph.end() or graph.find(second) == graph.end())
-		throw exception("Respected nodes of edge do not exist in the graph");
+	if (!has_nodes(first, second))
+		throw runtime_error("Respected nodes of edge do not exist in the graph");
 
-	map<Datatype, double>& firstMap = graph[first];
+	CPPLIB_COUNT(graph_lookups, 2);
+	const map<Datatype, double>& firstMap = graph[first].neighbours();
 	if (firstMap.find(second) == firstMap.end())
-		throw exception("Given edge not found in the graph");
+		throw runtime_error("Given edge not found in the graph");
+
+	CPPLIB_COUNT(graph_lookups, 4);
+	graph[first].modify()[second] = weight;
+	graph[second].modify()[first] = weight;
+}
+
+// Inserts a batch of undirected edges in one pass. Edges repeated within the batch,
+// edges already in the graph and edges with missing endpoints are counted in the
+// returned summary instead of throwing; the first occurrence of a repeated edge wins.
+template<typename Datatype>
+template<typename Range>
+Insert_Summary Graph<Datatype> ::insert_edges(const Range& edges, bool create_nodes) {
+	CPPLIB_SCOPE("Graph::insert_edges");
+	Insert_Summary summary;
+
+	vector<tuple<Datatype, Datatype, size_t, double> > batch;
+	for (const Edge<Datatype>& edge : edges) {
+		Datatype first = edge.getFirst();
+		Datatype second = edge.getSecond();
+		if (second < first)
+			swap(first, second);
+		batch.emplace_back(first, second, batch.size(), edge.getWeight());
+	}
+	parallel_sort(batch);
+
+	vector<tuple<Datatype, Datatype, double> > half_edges;
+	half_edges.reserve(2 * batch.size());
+	for (size_t i = 0; i < batch.size(); i++) {
+		const auto& [first, second, index, weight] = batch[i];
+		if (i > 0 and !(get<0>(batch[i - 1]) < first) and !(get<1>(batch[i - 1]) < second)) {
+			summary.duplicates++;
+			continue;
+		}
+		CPPLIB_COUNT(graph_lookups, 2);
 
-	firstMap[second] = weight;
-	graph[second][first] = weight;
+		auto firstNode = graph.find(first);
+		auto secondNode = graph.find(second);
+		if (!create_nodes and (firstNode == graph.end() or secondNode == graph.end())) {
+			summary.missing++;
+			continue;
+		}
+		CPPLIB_COUNT(graph_lookups, 1);
+		if (firstNode == graph.end()) {
+			firstNode = graph.emplace(first, Shared_Adjacency<Datatype>()).first;
+			summary.created_nodes++;
+		}
+		if (secondNode == graph.end() and (first < second)) {
+			graph.emplace(second, Shared_Adjacency<Datatype>());
+			summary.created_nodes++;
+		}
+
+		if (firstNode->second.neighbours().count(second) != 0) {
+			summary.existing++;
+			continue;
+		}
+
+		half_edges.emplace_back(first, second, weight);
+		if (first < second)
+			half_edges.emplace_back(second, first, weight);
+		summary.inserted++;
+	}
+	parallel_sort(half_edges);
+
+	auto node = graph.end();
+	map<Datatype, double>* adjacent = nullptr;
+	for (const auto& [first, second, weight] : half_edges) {
+		if (node == graph.end() or node->first < first) {
+			CPPLIB_COUNT(graph_lookups, 1);
+			node = graph.find(first);
+			adjacent = &node->second.modify();
+		}
+		adjacent->emplace_hint(adjacent->end(), second, weight);
+	}
+	return summary;
 }
 
 template<typename Datatype>
-int Graph<Datatype> ::total_components() {
+template<typename Range>
+Insert_Summary Graph<Datatype> ::build_from_edge_list(const Range& edges) {
+	graph.clear();
+	return insert_edges(edges, true);
+}
+
+template<typename Datatype>
+int Graph<Datatype> ::total_components() const {
+	CPPLIB_SCOPE("Graph::total_components");
+	CPPLIB_COUNT(graph_lookups, graph.size());
 	int count = 0;
 	map<Datatype, bool> visited;
 	for (auto& [first, second] : graph) {
@@ -133,30 +373,243 @@ int Graph<Datatype> ::total_components() {
 	return count;
 }
 
+// Sorts the edges once (weight, then endpoints) and joins endpoints through union-find.
 template<typename Datatype>
-bool Graph<Datatype> ::has_edge(const Datatype& first, const Datatype& second) {
-	if (graph.find(first) == graph.end() or graph.find(second) == graph.end())
-		throw exception("Respected nodes of edge do not exist in the graph");
+Spanning_Forest<Datatype> Graph<Datatype> ::kruskal() const {
+	CPPLIB_SCOPE("Graph::kruskal");
+	vector<const Datatype*> nodes;
+	vector<tuple<double, uint32_t, uint32_t> > edges = indexed_edges(nodes);
+	CPPLIB_COUNT(edges_visited, edges.size());
+	parallel_sort(edges);
+
+	vector<uint32_t> parent(nodes.size()), rank(nodes.size(), 0);
+	iota(parent.begin(), parent.end(), 0);
+
+	Spanning_Forest<Datatype> forest;
+	for (const auto& [weight, first, second] : edges) {
+		if (!unite(parent, rank, first, second))
+			continue;
+		forest.edges.emplace_back(*nodes[first], *nodes[second], weight);
+		forest.total_weight += weight;
+		if (forest.edges.size() + 1 == nodes.size())
+			break;
+	}
+	return forest;
+}
 
-	const map<Datatype, double>& firstMap = graph[first];
+// Every round, each component picks its lightest outgoing edge in parallel (ties broken
+// by edge position so no cycle can form), the picked edges are joined, and edges that
+// became internal to a component are dropped. Components at least halve every round.
+template<typename Datatype>
+Spanning_Forest<Datatype> Graph<Datatype> ::boruvka() const {
+	CPPLIB_SCOPE("Graph::boruvka");
+	const uint64_t NONE = UINT64_MAX;
+
+	vector<const Datatype*> nodes;
+	vector<tuple<double, uint32_t, uint32_t> > edges = indexed_edges(nodes);
+
+	vector<uint32_t> parent(nodes.size()), rank(nodes.size(), 0), flattened(nodes.size());
+	iota(parent.begin(), parent.end(), 0);
+	vector<atomic<uint64_t> > cheapest(nodes.size());
+
+	auto lighter = [&edges](uint64_t edge, uint64_t other) {
+		return get<0>(edges[edge]) < get<0>(edges[other]) or (get<0>(edges[edge]) == get<0>(edges[other]) and edge < other);
+	};
+	auto relax = [&lighter, NONE](atomic<uint64_t>& best, uint64_t edge) {
+		uint64_t current = best.load(memory_order_relaxed);
+		while (current == NONE or lighter(edge, current))
+			if (best.compare_exchange_weak(current, edge, memory_order_relaxed))
+				break;
+	};
+
+	Spanning_Forest<Datatype> forest;
+	while (!edges.empty()) {
+		CPPLIB_COUNT(vertices_visited, nodes.size());
+		CPPLIB_COUNT(edges_visited, edges.size());
+		cpplib_detail::parallel_for(nodes.size(), PARALLEL_THRESHOLD, [&](size_t node) { cheapest[node].store(NONE, memory_order_relaxed); });
+		cpplib_detail::parallel_for(edges.size(), PARALLEL_THRESHOLD, [&](size_t edge) {
+			uint32_t first = parent[get<1>(edges[edge])];
+			uint32_t second = parent[get<2>(edges[edge])];
+			relax(cheapest[first], edge);
+			relax(cheapest[second], edge);
+		});
+
+		for (size_t node = 0; node < nodes.size(); node++) {
+			uint64_t edge = cheapest[node].load(memory_order_relaxed);
+			if (edge == NONE)
+				continue;
+			const auto& [weight, first, second] = edges[edge];
+			if (!unite(parent, rank, first, second))
+				continue;
+			forest.edges.emplace_back(*nodes[first], *nodes[second], weight);
+			forest.total_weight += weight;
+		}
+
+		cpplib_detail::parallel_for(nodes.size(), PARALLEL_THRESHOLD, [&](size_t node) {
+			uint32_t root = (uint32_t)node;
+			while (parent[root] != root)
+				root = parent[root];
+			flattened[node] = root;
+		});
+		parent.swap(flattened);
+
+		edges.erase(remove_if(edges.begin(), edges.end(), [&parent](const tuple<double, uint32_t, uint32_t>& edge) {
+			return parent[get<1>(edge)] == parent[get<2>(edge)];
+		}), edges.end());
+	}
+	return forest;
+}
+
+template<typename Datatype>
+Spanning_Forest<Datatype> Graph<Datatype> ::minimum_spanning_forest() const {
+	if (thread::hardware_concurrency() > 1 and graph.size() >= PARALLEL_THRESHOLD)
+		return boruvka();
+	return kruskal();
+}
+
+template<typename Datatype>
+Csr_Graph<Datatype> Graph<Datatype> ::to_csr() const {
+	CPPLIB_SCOPE("Graph::to_csr");
+	if (graph.size() > UINT32_MAX)
+		throw runtime_error("Graph has too many nodes for 32 bit CSR targets");
+	vector<Datatype> nodes;
+	vector<uint64_t> offsets(1, 0);
+	nodes.reserve(graph.size());
+	offsets.reserve(graph.size() + 1);
+	for (auto& [node, adjacent] : graph) {
+		nodes.push_back(node);
+		offsets.push_back(offsets.back() + adjacent.neighbours().size());
+	}
+
+	CPPLIB_COUNT(vertices_visited, graph.size());
+	CPPLIB_COUNT(edges_visited, offsets.back());
+
+	vector<uint32_t> targets;
+	vector<double> weights;
+	targets.reserve(offsets.back());
+	weights.reserve(offsets.back());
+	for (auto& [node, adjacent] : graph) {
+		auto position = nodes.begin();
+		for (auto& [next, weight] : adjacent.neighbours()) {
+			position = lower_bound(position, nodes.end(), next);
+			targets.push_back((uint32_t)(position - nodes.begin()));
+			weights.push_back(weight);
+		}
+	}
+	return Csr_Graph<Datatype>(move(nodes), move(offsets), move(targets), move(weights));
+}
+
+template<typename Datatype>
+bool Graph<Datatype> ::has_edge(const Datatype& first, const Datatype& second) const {
+	if (!has_nodes(first, second))
+		throw runtime_error("Respected nodes of edge do not exist in the graph");
+	CPPLIB_COUNT(graph_lookups, 2);
+
+	const map<Datatype, double>& firstMap = graph.at(first).neighbours();
 	return firstMap.find(second) != firstMap.end();
 }
 
 template<typename Datatype>
-bool Graph<Datatype> ::has_connection(const Datatype& first, const Datatype& second) {
-	if (graph.find(first) == graph.end() or graph.find(second) == graph.end())
-		throw exception("Respected nodes of edge do not exist in the graph");
+bool Graph<Datatype> ::has_connection(const Datatype& first, const Datatype& second) const {
+	CPPLIB_SCOPE("Graph::has_connection");
+	if (!has_nodes(first, second))
+		throw runtime_error("Respected nodes of edge do not exist in the graph");
+	CPPLIB_COUNT(graph_lookups, 1);
 
 	map<Datatype, bool> visited;
 	dfs_util(first, visited);
 	return visited.find(second) != visited.end();
 }
 
+// Searches for the second node only when the first exists, and counts each search.
 template<typename Datatype>
-void Graph<Datatype> ::dfs_util(const Datatype& node, map<Datatype, bool>& visited) {
+bool Graph<Datatype> ::has_nodes(const Datatype& first, const Datatype& second) const {
+	CPPLIB_COUNT(graph_lookups, 1);
+	if (graph.find(first) == graph.end())
+		return false;
+	CPPLIB_COUNT(graph_lookups, 1);
+	return graph.find(second) != graph.end();
+}
+
+template<typename Datatype>
+void Graph<Datatype> ::dfs_util(const Datatype& node, map<Datatype, bool>& visited) const {
 	visited[node] = true;
-	for (auto& [first, second] : graph[node]) {
+	const map<Datatype, double>& adjacent = graph.at(node).neighbours();
+	CPPLIB_COUNT(vertices_visited, 1);
+	CPPLIB_COUNT(edges_visited, adjacent.size());
+	CPPLIB_COUNT(graph_lookups, 2 + adjacent.size());
+	for (auto& [first, second] : adjacent) {
 		if (visited.find(first) == visited.end())
 			dfs_util(first, visited);
 	}
-}
\ No newline at end of file
+}
+
+// Sorts chunks on separate threads, then merges neighbouring runs level by level.
+template<typename Datatype>
+template<typename Type>
+void Graph<Datatype> ::parallel_sort(vector<Type>& items) {
+	size_t threads = max<size_t>(1, thread::hardware_concurrency());
+	if (threads == 1 or items.size() < PARALLEL_THRESHOLD) {
+		sort(items.begin(), items.end());
+		return;
+	}
+
+	size_t chunk = (items.size() + threads - 1) / threads;
+	cpplib_detail::parallel_for((items.size() + chunk - 1) / chunk, 1, [&items, chunk](size_t index) {
+		sort(items.begin() + index * chunk, items.begin() + min((index + 1) * chunk, items.size()));
+	});
+
+	for (size_t width = chunk; width < items.size(); width *= 2)
+		cpplib_detail::parallel_for((items.size() - width + 2 * width - 1) / (2 * width), 1, [&items, width](size_t index) {
+			size_t begin = index * 2 * width;
+			inplace_merge(items.begin() + begin, items.begin() + begin + width,
+				items.begin() + min(begin + 2 * width, items.size()));
+		});
+}
+
+// Numbers the nodes in key order and lists every edge once, from the smaller key to the
+// larger one, as (weight, first index, second index). Self loops are left out.
+template<typename Datatype>
+vector<tuple<double, uint32_t, uint32_t> > Graph<Datatype> ::indexed_edges(vector<const Datatype*>& nodes) const {
+	nodes.clear();
+	nodes.reserve(graph.size());
+	for (auto& [node, adjacent] : graph)
+		nodes.push_back(&node);
+
+	auto before = [](const Datatype* node, const Datatype& key) { return *node < key; };
+	vector<tuple<double, uint32_t, uint32_t> > edges;
+	uint32_t index = 0;
+	for (auto& [node, adjacent] : graph) {
+		const map<Datatype, double>& neighbours = adjacent.neighbours();
+		auto position = nodes.begin() + index + 1;
+		for (auto next = neighbours.upper_bound(node); next != neighbours.end(); next++) {
+			position = lower_bound(position, nodes.end(), next->first, before);
+			edges.emplace_back(next->second, index, (uint32_t)(position - nodes.begin()));
+		}
+		index++;
+	}
+	return edges;
+}
+
+template<typename Datatype>
+uint32_t Graph<Datatype> ::find_root(vector<uint32_t>& parent, uint32_t node) {
+	while (parent[node] != node) {
+		parent[node] = parent[parent[node]];
+		node = parent[node];
+	}
+	return node;
+}
+
+template<typename Datatype>
+bool Graph<Datatype> ::unite(vector<uint32_t>& parent, vector<uint32_t>& rank, uint32_t first, uint32_t second) {
+	first = find_root(parent, first);
+	second = find_root(parent, second);
+	if (first == second)
+		return false;
+	if (rank[first] < rank[second])
+		swap(first, second);
+	parent[second] = first;
+	if (rank[first] == rank[second])
+		rank[first]++;
+	return true;
+}
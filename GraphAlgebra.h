@@ -0,0 +1,237 @@
+#pragma once
+
+#include "Graph.h"
+#include "Matrix.h"
+#include <cmath>
+
+
+// Linear algebra view of graphs: dense and sparse adjacency matrices, plus PageRank and
+// triangle counting run directly on the CSR arrays. Row i / column i of every matrix is
+// vertex i of the Csr_Graph, i.e. the i-th smallest key for a graph built with to_csr().
+
+template<typename T>
+class Sparse_Matrix
+{
+public:
+	Sparse_Matrix() {}
+	Sparse_Matrix(size_t, size_t, vector<uint64_t>&&, vector<uint32_t>&&, vector<T>&&);
+
+	size_t size() const { return _row_size; }
+	size_t rsize() const { return _column_size; }
+	size_t non_zeros() const { return values.size(); }
+
+	const uint64_t* row_offsets() const { return offsets.data(); }
+	const uint32_t* column_indices() const { return columns.data(); }
+	const T* data() const { return values.data(); }
+
+	Matrix<T> to_dense() const;
+	vector<T> operator *(const vector<T>&) const;
+
+private:
+	size_t _row_size = 0, _column_size = 0;
+	vector<uint64_t> offsets;
+	vector<uint32_t> columns;
+	vector<T> values;
+};
+
+
+template<typename T, typename Datatype>
+Matrix<T> to_adjacency_matrix(const Csr_Graph<Datatype>&);
+
+template<typename T, typename Datatype>
+Matrix<T> to_adjacency_matrix(const Graph<Datatype>&);
+
+template<typename T, typename Datatype>
+Sparse_Matrix<T> to_sparse_matrix(const Csr_Graph<Datatype>&);
+
+template<typename Datatype>
+vector<double> pagerank(const Csr_Graph<Datatype>&, double damping = 0.85, double tolerance = 1e-9, size_t max_iterations = 100);
+
+template<typename Datatype>
+vector<double> personalized_pagerank(const Csr_Graph<Datatype>&, const vector<uint32_t>&, double damping = 0.85,
+	double tolerance = 1e-9, size_t max_iterations = 100);
+
+template<typename Datatype>
+uint64_t count_triangles(const Csr_Graph<Datatype>&);
+
+
+template<typename T>
+Sparse_Matrix<T> ::Sparse_Matrix(size_t rows, size_t columns, vector<uint64_t>&& offsets, vector<uint32_t>&& indices, vector<T>&& values) {
+	_row_size = rows;
+	_column_size = columns;
+	this->offsets = move(offsets);
+	this->columns = move(indices);
+	this->values = move(values);
+}
+
+template<typename T>
+Matrix<T> Sparse_Matrix<T> ::to_dense() const {
+	Matrix<T> _return_matrix(_row_size, _column_size, (T)0);
+	for (size_t _row_i = 0; _row_i < _row_size; _row_i++)
+		for (uint64_t _entry_i = offsets[_row_i]; _entry_i < offsets[_row_i + 1]; _entry_i++)
+			_return_matrix[_row_i][columns[_entry_i]] = values[_entry_i];
+	return _return_matrix;
+}
+
+// Row parallel sparse matrix - vector product; returns an empty vector on a size mismatch.
+template<typename T>
+vector<T> Sparse_Matrix<T> ::operator*(const vector<T>& other) const {
+	if (other.size() != _column_size) return vector<T>();
+	vector<T> _return_vector(_row_size);
+	const uint64_t* _offsets = offsets.data();
+	const uint32_t* _columns = columns.data();
+	const T* _values = values.data();
+	const T* _input = other.data();
+	T* _output = _return_vector.data();
+	CPPLIB_COUNT(matrix_flops, 2 * values.size());
+	cpplib_detail::parallel_blocks(_row_size, cpplib_detail::PARALLEL_BLOCK, [=](size_t, size_t begin, size_t end) {
+		for (size_t _row_i = begin; _row_i < end; _row_i++) {
+			T _sum = 0;
+			for (uint64_t _entry_i = _offsets[_row_i]; _entry_i < _offsets[_row_i + 1]; _entry_i++)
+				_sum += _values[_entry_i] * _input[_columns[_entry_i]];
+			_output[_row_i] = _sum;
+		}
+	});
+	return _return_vector;
+}
+
+
+template<typename T, typename Datatype>
+Matrix<T> to_adjacency_matrix(const Csr_Graph<Datatype>& csr) {
+	return to_sparse_matrix<T>(csr).to_dense();
+}
+
+template<typename T, typename Datatype>
+Matrix<T> to_adjacency_matrix(const Graph<Datatype>& graph) {
+	return to_adjacency_matrix<T>(graph.to_csr());
+}
+
+template<typename T, typename Datatype>
+Sparse_Matrix<T> to_sparse_matrix(const Csr_Graph<Datatype>& csr) {
+	size_t nodes = csr.node_count();
+	vector<uint64_t> offsets(csr.offsets(), csr.offsets() + (nodes == 0 ? 0 : nodes + 1));
+	if (nodes == 0)
+		offsets.push_back(0);
+	vector<uint32_t> columns(csr.targets(), csr.targets() + csr.edge_count());
+	vector<T> values(csr.edge_count());
+	for (size_t edge = 0; edge < csr.edge_count(); edge++)
+		values[edge] = (T)csr.weights()[edge];
+	return Sparse_Matrix<T>(nodes, nodes, move(offsets), move(columns), move(values));
+}
+
+
+// Vertices per PageRank block. Each iteration starts its workers afresh, so a block
+// must gather enough edges to pay for the thread start.
+const size_t PAGERANK_BLOCK = 1 << 14;
+
+// Power iteration over the unweighted adjacency. Ranks are kept scaled by the inverse
+// degree, so the per-row kernel is a plain gather-and-sum over the CSR targets, and the
+// pass that computes the new ranks also scales them for the next round: one parallel
+// pass per iteration. Rank held by isolated vertices is redistributed like the teleport
+// mass.
+template<typename Datatype>
+vector<double> pagerank_iterate(const Csr_Graph<Datatype>& csr, const vector<double>& teleport, double damping,
+	double tolerance, size_t max_iterations) {
+	CPPLIB_SCOPE("pagerank");
+	size_t nodes = csr.node_count();
+	const uint64_t* offsets = csr.offsets();
+	const uint32_t* targets = csr.targets();
+
+	vector<double> rank(teleport), next(nodes), contribution(nodes), next_contribution(nodes);
+	size_t workers = cpplib_detail::worker_count(nodes, PAGERANK_BLOCK);
+	vector<double> dangling(workers), error(workers);
+	double lost = 0;
+	for (size_t node = 0; node < nodes; node++) {
+		uint64_t degree = offsets[node + 1] - offsets[node];
+		contribution[node] = degree == 0 ? 0.0 : rank[node] / (double)degree;
+		lost += degree == 0 ? rank[node] : 0.0;
+	}
+
+	for (size_t iteration = 0; iteration < max_iterations; iteration++) {
+		CPPLIB_COUNT(vertices_visited, nodes);
+		CPPLIB_COUNT(edges_visited, csr.edge_count());
+		fill(dangling.begin(), dangling.end(), 0.0);
+		fill(error.begin(), error.end(), 0.0);
+
+		double base = 1.0 - damping + damping * lost;
+		cpplib_detail::parallel_blocks(nodes, PAGERANK_BLOCK, [&](size_t worker, size_t begin, size_t end) {
+			double change = 0, dangling_rank = 0;
+			for (size_t node = begin; node < end; node++) {
+				double sum = 0;
+				for (uint64_t edge = offsets[node]; edge < offsets[node + 1]; edge++)
+					sum += contribution[targets[edge]];
+				next[node] = base * teleport[node] + damping * sum;
+				change += fabs(next[node] - rank[node]);
+
+				uint64_t degree = offsets[node + 1] - offsets[node];
+				next_contribution[node] = degree == 0 ? 0.0 : next[node] / (double)degree;
+				dangling_rank += degree == 0 ? next[node] : 0.0;
+			}
+			dangling[worker] += dangling_rank;
+			error[worker] += change;
+		});
+
+		rank.swap(next);
+		contribution.swap(next_contribution);
+		lost = accumulate(dangling.begin(), dangling.end(), 0.0);
+		if (accumulate(error.begin(), error.end(), 0.0) < tolerance)
+			break;
+	}
+	return rank;
+}
+
+template<typename Datatype>
+vector<double> pagerank(const Csr_Graph<Datatype>& csr, double damping, double tolerance, size_t max_iterations) {
+	if (csr.node_count() == 0)
+		return vector<double>();
+	vector<double> teleport(csr.node_count(), 1.0 / csr.node_count());
+	return pagerank_iterate(csr, teleport, damping, tolerance, max_iterations);
+}
+
+// Teleports only to `sources` (vertex indices of the Csr_Graph), spread evenly.
+template<typename Datatype>
+vector<double> personalized_pagerank(const Csr_Graph<Datatype>& csr, const vector<uint32_t>& sources, double damping,
+	double tolerance, size_t max_iterations) {
+	if (sources.empty())
+		throw runtime_error("Personalized PageRank needs at least one source");
+	vector<double> teleport(csr.node_count(), 0.0);
+	for (uint32_t source : sources) {
+		if (source >= csr.node_count())
+			throw runtime_error("Node does not exist in graph");
+		teleport[source] += 1.0 / sources.size();
+	}
+	return pagerank_iterate(csr, teleport, damping, tolerance, max_iterations);
+}
+
+// Counts each triangle u < v < w once by intersecting the higher neighbours of u and v.
+// Neighbour lists must be sorted by index, which holds for to_csr(), relabel() and
+// open_binary(). Relabelling with degree_order first keeps hub intersections short.
+template<typename Datatype>
+uint64_t count_triangles(const Csr_Graph<Datatype>& csr) {
+	CPPLIB_SCOPE("count_triangles");
+	size_t nodes = csr.node_count();
+	const uint64_t* offsets = csr.offsets();
+	const uint32_t* targets = csr.targets();
+
+	vector<uint64_t> counts(cpplib_detail::worker_count(nodes, cpplib_detail::PARALLEL_BLOCK), 0);
+	cpplib_detail::parallel_blocks(nodes, cpplib_detail::PARALLEL_BLOCK, [&](size_t worker, size_t begin, size_t end) {
+		uint64_t found = 0;
+		for (size_t node = begin; node < end; node++) {
+			const uint32_t* node_end = targets + offsets[node + 1];
+			const uint32_t* higher = upper_bound(targets + offsets[node], node_end, (uint32_t)node);
+			for (const uint32_t* next = higher; next != node_end; next++) {
+				const uint32_t* first = next + 1;
+				const uint32_t* next_end = targets + offsets[*next + 1];
+				const uint32_t* second = upper_bound(targets + offsets[*next], next_end, *next);
+				while (first != node_end and second != next_end) {
+					found += *first == *second;
+					uint32_t first_value = *first, second_value = *second;
+					first += first_value <= second_value;
+					second += second_value <= first_value;
+				}
+			}
+		}
+		counts[worker] += found;
+	});
+	return accumulate(counts.begin(), counts.end(), (uint64_t)0);
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include "Graph.h"
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// Read-only memory mapping of a whole file, released when the object is destroyed.
+class Mapped_File
+{
+public:
+	Mapped_File(const string&);
+	Mapped_File(const Mapped_File&) = delete;
+	Mapped_File& operator=(const Mapped_File&) = delete;
+	~Mapped_File();
+
+	const char* data() const { return file_data; }
+	size_t size() const { return file_size; }
+
+private:
+	const char* file_data = nullptr;
+	size_t file_size = 0;
+#ifdef _WIN32
+	HANDLE file_handle = INVALID_HANDLE_VALUE;
+	HANDLE mapping_handle = nullptr;
+#else
+	int file_descriptor = -1;
+#endif
+};
+
+
+// On-disk layout written by save_binary, all sections in native byte order:
+//   header | offsets[node_count + 1] (uint64) | weights[edge_count] (double)
+//   | targets[edge_count] (uint32) | padding to 8 bytes | nodes[node_count] (Datatype)
+struct Binary_Graph_Header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t node_width;
+	uint64_t node_count;
+	uint64_t edge_count;
+};
+
+const char BINARY_GRAPH_MAGIC[8] = { 'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H' };
+const uint32_t BINARY_GRAPH_VERSION = 1;
+
+
+template<typename Datatype>
+Insert_Summary load_edge_list(Graph<Datatype>&, const string&);
+
+template<typename Datatype>
+vector<Edge<Datatype> > read_edge_list(const string&);
+
+template<typename Datatype>
+void save_binary(const Csr_Graph<Datatype>&, const string&);
+
+template<typename Datatype>
+Csr_Graph<Datatype> open_binary(const string&);
+
+
+#ifdef _WIN32
+inline Mapped_File ::Mapped_File(const string& path) {
+	file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_handle == INVALID_HANDLE_VALUE)
+		throw runtime_error("Unable to open file");
+
+	LARGE_INTEGER length;
+	if (!GetFileSizeEx(file_handle, &length)) {
+		CloseHandle(file_handle);
+		throw runtime_error("Unable to read file size");
+	}
+	file_size = (size_t)length.QuadPart;
+	if (file_size == 0)
+		return;
+
+	mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_handle != nullptr)
+		file_data = (const char*)MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+	if (file_data == nullptr) {
+		if (mapping_handle != nullptr)
+			CloseHandle(mapping_handle);
+		CloseHandle(file_handle);
+		throw runtime_error("Unable to map file");
+	}
+}
+
+inline Mapped_File ::~Mapped_File() {
+	if (file_data != nullptr)
+		UnmapViewOfFile(file_data);
+	if (mapping_handle != nullptr)
+		CloseHandle(mapping_handle);
+	if (file_handle != INVALID_HANDLE_VALUE)
+		CloseHandle(file_handle);
+}
+#else
+inline Mapped_File ::Mapped_File(const string& path) {
+	file_descriptor = open(path.c_str(), O_RDONLY);
+	if (file_descriptor < 0)
+		throw runtime_error("Unable to open file");
+
+	struct stat status;
+	if (fstat(file_descriptor, &status) != 0) {
+		close(file_descriptor);
+		throw runtime_error("Unable to read file size");
+	}
+	file_size = (size_t)status.st_size;
+	if (file_size == 0)
+		return;
+
+	void* mapped = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+	if (mapped == MAP_FAILED) {
+		close(file_descriptor);
+		throw runtime_error("Unable to map file");
+	}
+	file_data = (const char*)mapped;
+}
+
+inline Mapped_File ::~Mapped_File() {
+	if (file_data != nullptr)
+		munmap((void*)file_data, file_size);
+	if (file_descriptor >= 0)
+		close(file_descriptor);
+}
+#endif
+
+
+inline const char* skip_blanks(const char* position, const char* end) {
+	while (position != end and (*position == ' ' or *position == '\t' or *position == '\r'))
+		position++;
+	return position;
+}
+
+// Parses "src dst [weight]" lines in [position, end). Fields must be separated by
+// blanks; blank lines and lines starting with '#' or '%' are skipped. Returns false on
+// the first malformed line.
+template<typename Datatype>
+bool parse_edge_lines(const char* position, const char* end, vector<Edge<Datatype> >& edges) {
+	while (position < end) {
+		const char* line_end = find(position, end, '\n');
+		const char* cursor = skip_blanks(position, line_end);
+		position = line_end + 1;
+		if (cursor == line_end or *cursor == '#' or *cursor == '%')
+			continue;
+
+		Datatype first, second;
+		double weight = 1.0;
+		auto [after_first, first_error] = from_chars(cursor, line_end, first);
+		if (first_error != errc())
+			return false;
+		cursor = skip_blanks(after_first, line_end);
+		if (cursor == after_first)
+			return false;
+		auto [after_second, second_error] = from_chars(cursor, line_end, second);
+		if (second_error != errc())
+			return false;
+		cursor = skip_blanks(after_second, line_end);
+		if (cursor != line_end and cursor == after_second)
+			return false;
+		if (cursor != line_end) {
+			auto [after_weight, weight_error] = from_chars(cursor, line_end, weight);
+			if (weight_error != errc() or skip_blanks(after_weight, line_end) != line_end)
+				return false;
+		}
+		edges.emplace_back(first, second, weight);
+	}
+	return true;
+}
+
+// Smallest share of an edge list file worth parsing on a separate worker.
+const size_t EDGE_LIST_CHUNK = 1 << 20;
+
+// Maps a text edge list and parses it in one chunk per worker; chunk borders are moved
+// forward to the next line break so that no line is split between two workers.
+template<typename Datatype>
+vector<Edge<Datatype> > read_edge_list(const string& path) {
+	static_assert(is_arithmetic<Datatype>::value, "Edge lists can only be parsed into arithmetic node types");
+
+	Mapped_File file(path);
+	const char* begin = file.data();
+	const char* end = file.data() + file.size();
+
+	size_t threads = cpplib_detail::worker_count(file.size(), EDGE_LIST_CHUNK);
+	vector<const char*> borders(1, begin);
+	for (size_t i = 1; i < threads; i++) {
+		const char* border = max(begin + file.size() * i / threads, borders.back());
+		border = find(border, end, '\n');
+		borders.push_back(border == end ? end : border + 1);
+	}
+	borders.push_back(end);
+
+	vector<vector<Edge<Datatype> > > chunks(threads);
+	vector<char> parsed(threads, false);
+	cpplib_detail::parallel_for(threads, 1, [&](size_t i) { parsed[i] = parse_edge_lines(borders[i], borders[i + 1], chunks[i]); });
+
+	size_t total = 0;
+	for (size_t i = 0; i < threads; i++) {
+		if (!parsed[i])
+			throw runtime_error("Malformed line in edge list");
+		total += chunks[i].size();
+	}
+
+	vector<Edge<Datatype> > edges;
+	edges.reserve(total);
+	for (vector<Edge<Datatype> >& chunk : chunks)
+		edges.insert(edges.end(), chunk.begin(), chunk.end());
+	return edges;
+}
+
+template<typename Datatype>
+Insert_Summary load_edge_list(Graph<Datatype>& graph, const string& path) {
+	return graph.build_from_edge_list(read_edge_list<Datatype>(path));
+}
+
+
+inline size_t align_binary_section(size_t offset) { return (offset + 7) & ~(size_t)7; }
+
+// Consumers index targets and weights through offsets, and vertices through targets,
+// without bounds checks. One read-only pass over the mapped arrays makes sure offsets
+// start at 0, never decrease and end at edge_count, and every target names a vertex.
+inline bool valid_csr_arrays(uint64_t node_count, uint64_t edge_count, const uint64_t* offsets, const uint32_t* targets) {
+	if (offsets[0] != 0 or offsets[node_count] != edge_count)
+		return false;
+	vector<char> valid(cpplib_detail::worker_count(node_count + edge_count, cpplib_detail::PARALLEL_BLOCK), true);
+	cpplib_detail::parallel_blocks(node_count, cpplib_detail::PARALLEL_BLOCK, [&](size_t worker, size_t begin, size_t end) {
+		for (size_t node = begin; node < end; node++)
+			if (offsets[node + 1] < offsets[node])
+				valid[worker] = false;
+	});
+	cpplib_detail::parallel_blocks(edge_count, cpplib_detail::PARALLEL_BLOCK, [&](size_t worker, size_t begin, size_t end) {
+		for (size_t edge = begin; edge < end; edge++)
+			if (targets[edge] >= node_count)
+				valid[worker] = false;
+	});
+	return find(valid.begin(), valid.end(), false) == valid.end();
+}
+
+template<typename Datatype>
+void save_binary(const Csr_Graph<Datatype>& csr, const string& path) {
+	static_assert(is_trivially_copyable<Datatype>::value, "Binary graphs require trivially copyable node types");
+
+	Binary_Graph_Header header;
+	memcpy(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic));
+	header.version = BINARY_GRAPH_VERSION;
+	header.node_width = (uint32_t)sizeof(Datatype);
+	header.node_count = csr.node_count();
+	header.edge_count = csr.edge_count();
+
+	ofstream output(path, ios::binary | ios::trunc);
+	if (!output)
+		throw runtime_error("Unable to open file");
+
+	uint64_t empty_offset = 0;
+	const uint64_t* offsets = csr.node_count() == 0 ? &empty_offset : csr.offsets();
+	size_t targets_end = sizeof(header) + (header.node_count + 1) * sizeof(uint64_t)
+		+ header.edge_count * (sizeof(double) + sizeof(uint32_t));
+	const char padding[8] = {};
+
+	output.write((const char*)&header, sizeof(header));
+	output.write((const char*)offsets, (header.node_count + 1) * sizeof(uint64_t));
+	output.write((const char*)csr.weights(), header.edge_count * sizeof(double));
+	output.write((const char*)csr.targets(), header.edge_count * sizeof(uint32_t));
+	output.write(padding, align_binary_section(targets_end) - targets_end);
+	output.write((const char*)csr.nodes(), header.node_count * sizeof(Datatype));
+	if (!output)
+		throw runtime_error("Unable to write binary graph");
+}
+
+// Reopens a file written by save_binary without copying: the returned graph points
+// straight into the mapping, which stays alive for as long as any copy of the graph.
+template<typename Datatype>
+Csr_Graph<Datatype> open_binary(const string& path) {
+	static_assert(is_trivially_copyable<Datatype>::value, "Binary graphs require trivially copyable node types");
+	static_assert(alignof(Datatype) <= 8, "Binary graphs require node types aligned to at most 8 bytes");
+
+	shared_ptr<Mapped_File> file = make_shared<Mapped_File>(path);
+	Binary_Graph_Header header;
+	if (file->size() < sizeof(header))
+		throw runtime_error("File is not a binary graph");
+	memcpy(&header, file->data(), sizeof(header));
+	if (memcmp(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic)) != 0 or header.version != BINARY_GRAPH_VERSION)
+		throw runtime_error("File is not a binary graph");
+	if (header.node_width != sizeof(Datatype))
+		throw runtime_error("Binary graph was saved with a different node type");
+	if (header.node_count > UINT32_MAX)
+		throw runtime_error("Binary graph has too many nodes for 32 bit CSR targets");
+	if (header.edge_count > file->size())
+		throw runtime_error("Binary graph is truncated");
+
+	size_t offsets_begin = sizeof(header);
+	size_t weights_begin = offsets_begin + (header.node_count + 1) * sizeof(uint64_t);
+	size_t targets_begin = weights_begin + header.edge_count * sizeof(double);
+	size_t nodes_begin = align_binary_section(targets_begin + header.edge_count * sizeof(uint32_t));
+	if (file->size() != nodes_begin + header.node_count * sizeof(Datatype))
+		throw runtime_error("Binary graph is truncated");
+
+	const char* data = file->data();
+	if (!valid_csr_arrays(header.node_count, header.edge_count, (const uint64_t*)(data + offsets_begin),
+		(const uint32_t*)(data + targets_begin)))
+		throw runtime_error("Binary graph has inconsistent offsets or targets");
+
+	return Csr_Graph<Datatype>(file, header.node_count, (const Datatype*)(data + nodes_begin),
+		(const uint64_t*)(data + offsets_begin), (const uint32_t*)(data + targets_begin), (const double*)(data + weights_begin));
+}
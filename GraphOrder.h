@@ -0,0 +1,186 @@
+#pragma once
+
+#include "Graph.h"
+#include <cmath>
+#include <queue>
+
+
+// Vertex orderings for Csr_Graph. Every ordering is returned as a permutation `rank`,
+// where rank[old index] is the new index of that vertex; relabel applies it and
+// restore_order maps per-vertex results of the relabelled graph back to the old order.
+
+template<typename Datatype>
+vector<uint32_t> degree_order(const Csr_Graph<Datatype>&, bool hubs_only = true);
+
+template<typename Datatype>
+vector<uint32_t> reverse_cuthill_mckee(const Csr_Graph<Datatype>&);
+
+template<typename Datatype>
+vector<uint32_t> gorder(const Csr_Graph<Datatype>&, size_t window = 5);
+
+template<typename Datatype>
+Csr_Graph<Datatype> relabel(const Csr_Graph<Datatype>&, const vector<uint32_t>&);
+
+template<typename Type>
+vector<Type> restore_order(const vector<Type>&, const vector<uint32_t>&);
+
+
+inline vector<uint32_t> invert_order(const vector<uint32_t>& order) {
+	vector<uint32_t> rank(order.size());
+	for (uint32_t i = 0; i < order.size(); i++)
+		rank[order[i]] = i;
+	return rank;
+}
+
+// Sorts vertices by decreasing degree. With hubs_only, only vertices of above average
+// degree move to the front and the rest keep their relative order (hub sorting), which
+// keeps whatever locality the original numbering had.
+template<typename Datatype>
+vector<uint32_t> degree_order(const Csr_Graph<Datatype>& csr, bool hubs_only) {
+	size_t nodes = csr.node_count();
+	double average = nodes == 0 ? 0 : (double)csr.edge_count() / nodes;
+
+	vector<uint32_t> order(nodes);
+	iota(order.begin(), order.end(), 0);
+	auto hub_end = hubs_only ? stable_partition(order.begin(), order.end(), [&](uint32_t node) { return csr.degree(node) > average; })
+		: order.end();
+	stable_sort(order.begin(), hub_end, [&](uint32_t first, uint32_t second) { return csr.degree(first) > csr.degree(second); });
+	return invert_order(order);
+}
+
+// Breadth first search from a minimum degree vertex of every component, visiting
+// neighbours by increasing degree; the reversed visit order keeps the bandwidth small.
+template<typename Datatype>
+vector<uint32_t> reverse_cuthill_mckee(const Csr_Graph<Datatype>& csr) {
+	size_t nodes = csr.node_count();
+	vector<uint32_t> starts(nodes);
+	iota(starts.begin(), starts.end(), 0);
+	stable_sort(starts.begin(), starts.end(), [&](uint32_t first, uint32_t second) { return csr.degree(first) < csr.degree(second); });
+
+	vector<uint32_t> order;
+	vector<char> visited(nodes, false);
+	vector<uint32_t> neighbours;
+	order.reserve(nodes);
+	for (uint32_t start : starts) {
+		if (visited[start])
+			continue;
+		visited[start] = true;
+		order.push_back(start);
+		for (size_t head = order.size() - 1; head < order.size(); head++) {
+			uint32_t node = order[head];
+			neighbours.clear();
+			for (uint64_t edge = csr.offsets()[node]; edge < csr.offsets()[node + 1]; edge++)
+				if (!visited[csr.targets()[edge]]) {
+					visited[csr.targets()[edge]] = true;
+					neighbours.push_back(csr.targets()[edge]);
+				}
+			stable_sort(neighbours.begin(), neighbours.end(), [&](uint32_t first, uint32_t second) { return csr.degree(first) < csr.degree(second); });
+			order.insert(order.end(), neighbours.begin(), neighbours.end());
+		}
+	}
+	reverse(order.begin(), order.end());
+	return invert_order(order);
+}
+
+// Greedy Gorder heuristic: the next vertex is the unplaced one sharing the most edges and
+// common neighbours with the last `window` placed vertices. Neighbours of vertices with
+// degree above sqrt(nodes) are not expanded, since hubs would make every score update
+// quadratic. Scores live in a lazy max-heap that is only pushed to on increments; an
+// entry found above its vertex's current score is pushed again with the lower score.
+template<typename Datatype>
+vector<uint32_t> gorder(const Csr_Graph<Datatype>& csr, size_t window) {
+	size_t nodes = csr.node_count();
+	size_t hub_degree = max<size_t>(1, (size_t)sqrt((double)nodes));
+	const uint64_t* offsets = csr.offsets();
+	const uint32_t* targets = csr.targets();
+
+	vector<int64_t> score(nodes, 0);
+	vector<char> placed(nodes, false);
+	priority_queue<pair<int64_t, uint32_t> > candidates;
+
+	auto adjust = [&](uint32_t node, int64_t change) {
+		if (placed[node])
+			return;
+		score[node] += change;
+		if (change > 0)
+			candidates.emplace(score[node], node);
+	};
+	auto update = [&](uint32_t node, int64_t change) {
+		for (uint64_t edge = offsets[node]; edge < offsets[node + 1]; edge++) {
+			uint32_t next = targets[edge];
+			adjust(next, change);
+			if (csr.degree(next) > hub_degree)
+				continue;
+			for (uint64_t second = offsets[next]; second < offsets[next + 1]; second++)
+				if (targets[second] != node)
+					adjust(targets[second], change);
+		}
+	};
+
+	vector<uint32_t> order;
+	order.reserve(nodes);
+	uint32_t unplaced = 0;
+	while (order.size() < nodes) {
+		uint32_t node = (uint32_t)nodes;
+		while (!candidates.empty() and node == nodes) {
+			auto [best, candidate] = candidates.top();
+			candidates.pop();
+			if (placed[candidate] or best < score[candidate])
+				continue;
+			if (best > score[candidate])
+				candidates.emplace(score[candidate], candidate);
+			else if (best > 0)
+				node = candidate;
+		}
+		if (node == nodes) {
+			while (placed[unplaced])
+				unplaced++;
+			node = unplaced;
+		}
+
+		placed[node] = true;
+		order.push_back(node);
+		update(node, 1);
+		if (order.size() > window)
+			update(order[order.size() - window - 1], -1);
+	}
+	return invert_order(order);
+}
+
+// Builds the relabelled graph: vertex rank[v] of the result is vertex v of `csr`, and
+// every neighbour list is sorted by the new indices.
+template<typename Datatype>
+Csr_Graph<Datatype> relabel(const Csr_Graph<Datatype>& csr, const vector<uint32_t>& rank) {
+	size_t nodes = csr.node_count();
+	vector<uint32_t> order = invert_order(rank);
+
+	vector<Datatype> labels(nodes);
+	vector<uint64_t> offsets(nodes + 1, 0);
+	for (uint32_t node = 0; node < nodes; node++) {
+		labels[node] = csr.nodes()[order[node]];
+		offsets[node + 1] = offsets[node] + csr.degree(order[node]);
+	}
+
+	vector<uint32_t> targets(csr.edge_count());
+	vector<double> weights(csr.edge_count());
+	vector<pair<uint32_t, double> > adjacent;
+	for (uint32_t node = 0; node < nodes; node++) {
+		adjacent.clear();
+		for (uint64_t edge = csr.offsets()[order[node]]; edge < csr.offsets()[order[node] + 1]; edge++)
+			adjacent.emplace_back(rank[csr.targets()[edge]], csr.weights()[edge]);
+		sort(adjacent.begin(), adjacent.end());
+		for (size_t i = 0; i < adjacent.size(); i++) {
+			targets[offsets[node] + i] = adjacent[i].first;
+			weights[offsets[node] + i] = adjacent[i].second;
+		}
+	}
+	return Csr_Graph<Datatype>(move(labels), move(offsets), move(targets), move(weights));
+}
+
+template<typename Type>
+vector<Type> restore_order(const vector<Type>& values, const vector<uint32_t>& rank) {
+	vector<Type> restored(rank.size());
+	for (size_t node = 0; node < rank.size(); node++)
+		restored[node] = values[rank[node]];
+	return restored;
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+// Opt-in hot path instrumentation. Building with CPPLIB_INSTRUMENT defined (CMake option
+// of the same name) makes Vector, Matrix and Graph count allocations, element copies and
+// moves, matrix flops, graph lookups and visited vertices / edges into per-thread
+// counters, and time their expensive entry points. Without it the CPPLIB_COUNT and
+// CPPLIB_SCOPE macros expand to nothing and the containers are unchanged.
+//
+// The snapshot / report functions below are always available; they simply report zeros
+// in a build without instrumentation.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <ostream>
+#include <string>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace instrument
+{
+	struct Counters
+	{
+		uint64_t allocations = 0;
+		uint64_t bytes_allocated = 0;
+		uint64_t reallocations = 0;
+		uint64_t bytes_moved = 0;
+		uint64_t element_copies = 0;
+		uint64_t element_moves = 0;
+		uint64_t matrix_flops = 0;
+		// Searches in Graph's maps, counted as each one runs, so a throwing call counts
+		// exactly the searches it made before throwing.
+		uint64_t graph_lookups = 0;
+		uint64_t vertices_visited = 0;
+		uint64_t edges_visited = 0;
+
+		Counters operator -(const Counters& other) const
+		{
+			Counters _difference = *this;
+			_difference.allocations -= other.allocations;
+			_difference.bytes_allocated -= other.bytes_allocated;
+			_difference.reallocations -= other.reallocations;
+			_difference.bytes_moved -= other.bytes_moved;
+			_difference.element_copies -= other.element_copies;
+			_difference.element_moves -= other.element_moves;
+			_difference.matrix_flops -= other.matrix_flops;
+			_difference.graph_lookups -= other.graph_lookups;
+			_difference.vertices_visited -= other.vertices_visited;
+			_difference.edges_visited -= other.edges_visited;
+			return _difference;
+		}
+
+		void operator +=(const Counters& other)
+		{
+			allocations += other.allocations;
+			bytes_allocated += other.bytes_allocated;
+			reallocations += other.reallocations;
+			bytes_moved += other.bytes_moved;
+			element_copies += other.element_copies;
+			element_moves += other.element_moves;
+			matrix_flops += other.matrix_flops;
+			graph_lookups += other.graph_lookups;
+			vertices_visited += other.vertices_visited;
+			edges_visited += other.edges_visited;
+		}
+	};
+
+	struct Timer_Total
+	{
+		uint64_t calls = 0;
+		double seconds = 0;
+		Counters counters;
+	};
+
+	// Counters and timer totals of the calling thread.
+	inline Counters& local()
+	{
+		thread_local Counters _counters;
+		return _counters;
+	}
+
+	inline std::map<std::string, Timer_Total>& local_timers()
+	{
+		thread_local std::map<std::string, Timer_Total> _timers;
+		return _timers;
+	}
+
+	inline Counters snapshot() { return local(); }
+
+	inline void reset()
+	{
+		local() = Counters();
+		local_timers().clear();
+	}
+
+	// Trace markers in the systrace "B|pid|name" / "E|pid" format, written to the ftrace
+	// marker file so they line up with `perf record -e ftrace:print` or trace-cmd.
+	inline std::FILE*& marker_file()
+	{
+		static std::FILE* _file = nullptr;
+		return _file;
+	}
+
+	inline bool enable_trace_markers()
+	{
+#ifdef __linux__
+		if (marker_file() == nullptr)
+			marker_file() = std::fopen("/sys/kernel/tracing/trace_marker", "w");
+		if (marker_file() == nullptr)
+			marker_file() = std::fopen("/sys/kernel/debug/tracing/trace_marker", "w");
+		if (marker_file() != nullptr)
+			std::setvbuf(marker_file(), nullptr, _IONBF, 0);
+#endif
+		return marker_file() != nullptr;
+	}
+
+	inline void trace_marker(const char* name, bool begin)
+	{
+#ifdef __linux__
+		if (marker_file() == nullptr) return;
+		if (begin) std::fprintf(marker_file(), "B|%d|%s", (int)getpid(), name);
+		else std::fprintf(marker_file(), "E|%d", (int)getpid());
+#else
+		(void)name;
+		(void)begin;
+#endif
+	}
+
+	// Adds its wall time and the counter delta of its thread to the named timer total.
+	class Scoped_Timer
+	{
+	public:
+		explicit Scoped_Timer(const char* name) : _name(name), _start_counters(local())
+		{
+			trace_marker(_name, true);
+			_start = std::chrono::steady_clock::now();
+		}
+
+		Scoped_Timer(const Scoped_Timer&) = delete;
+		Scoped_Timer& operator =(const Scoped_Timer&) = delete;
+
+		~Scoped_Timer()
+		{
+			double _seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+			trace_marker(_name, false);
+			Timer_Total& _total = local_timers()[_name];
+			_total.calls++;
+			_total.seconds += _seconds;
+			_total.counters += local() - _start_counters;
+		}
+
+	private:
+		const char* _name;
+		Counters _start_counters;
+		std::chrono::steady_clock::time_point _start;
+	};
+
+	inline void write_json(std::ostream& _ostream, const Counters& _counters)
+	{
+		_ostream << "{ \"allocations\": " << _counters.allocations
+			<< ", \"bytes_allocated\": " << _counters.bytes_allocated
+			<< ", \"reallocations\": " << _counters.reallocations
+			<< ", \"bytes_moved\": " << _counters.bytes_moved
+			<< ", \"element_copies\": " << _counters.element_copies
+			<< ", \"element_moves\": " << _counters.element_moves
+			<< ", \"matrix_flops\": " << _counters.matrix_flops
+			<< ", \"graph_lookups\": " << _counters.graph_lookups
+			<< ", \"vertices_visited\": " << _counters.vertices_visited
+			<< ", \"edges_visited\": " << _counters.edges_visited << " }";
+	}
+
+	// Counters and per-scope totals of the calling thread as one JSON object.
+	inline void dump_json(std::ostream& _ostream)
+	{
+		_ostream << "{\n  \"counters\": ";
+		write_json(_ostream, local());
+		_ostream << ",\n  \"timers\": {";
+		bool _first = true;
+		for (const auto& [_name, _total] : local_timers()) {
+			_ostream << (_first ? "\n" : ",\n") << "    \"" << _name << "\": { \"calls\": " << _total.calls
+				<< ", \"seconds\": " << _total.seconds << ", \"counters\": ";
+			write_json(_ostream, _total.counters);
+			_ostream << " }";
+			_first = false;
+		}
+		_ostream << "\n  }\n}\n";
+	}
+}
+
+#define CPPLIB_INSTRUMENT_CONCAT_(a, b) a##b
+#define CPPLIB_INSTRUMENT_CONCAT(a, b) CPPLIB_INSTRUMENT_CONCAT_(a, b)
+
+#ifdef CPPLIB_INSTRUMENT
+#define CPPLIB_COUNT(counter, amount) (::instrument::local().counter += (uint64_t)(amount))
+#define CPPLIB_SCOPE(name) ::instrument::Scoped_Timer CPPLIB_INSTRUMENT_CONCAT(_cpplib_scope_, __LINE__)(name)
+#else
+#define CPPLIB_COUNT(counter, amount) ((void)0)
+#define CPPLIB_SCOPE(name) ((void)0)
+#endif
@@ -1,14 +1,25 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <utility>
 #include <vector>
 #include <istream>
 #include <ostream>
+#include <stdexcept>
+#include "Instrument.h"
 
 using std::vector;
 
+// Matrix<T> is sized at run time; Matrix<T, R, C> (at the end of this file) is sized at
+// compile time and keeps its elements inline.
+template<typename T, size_t R = 0, size_t C = 0>
+class Matrix;
+
 template<typename T>
-class Matrix
+class Matrix<T, 0, 0>
 {
 public:
 	Matrix();
@@ -46,13 +57,15 @@ public:
 	void operator *=(const Matrix<T>&);
 	void operator ^=(long long);
 
-	friend std::istream& operator >>(std::istream&, Matrix<T>&);
-	friend std::ostream& operator <<(std::ostream&, const Matrix<T>&);
+	template<typename U>
+	friend std::istream& operator >>(std::istream&, Matrix<U>&);
+	template<typename U>
+	friend std::ostream& operator <<(std::ostream&, const Matrix<U>&);
 
 	static Matrix<T> getIdentity(size_t _row, size_t _column)
 	{
 		Matrix<T> _return_matrix(_row, _column, (T)0);
-		for (size_t _row_i = 0; _row_i < _row_size; _row_i++)
+		for (size_t _row_i = 0; _row_i < _row && _row_i < _column; _row_i++)
 			_return_matrix[_row_i][_row_i] = 1;
 		return _return_matrix;
 	}
@@ -77,6 +90,8 @@ Matrix<T> ::Matrix(size_t row, size_t column)
 	_row_size = row;
 	_column_size = column;
 	matrix = vector<vector<T>>(row, vector<T>(column)); 
+	CPPLIB_COUNT(allocations, _row_size + (_row_size != 0));
+	CPPLIB_COUNT(bytes_allocated, _row_size * (_column_size * sizeof(T) + sizeof(vector<T>)));
 }
 
 template<typename T>
@@ -85,6 +100,8 @@ Matrix<T> ::Matrix(size_t row, size_t column, const T& value)
 	_row_size = row;
 	_column_size = column;
 	matrix = vector<vector<T>>(row, vector<T>(column, value)); 
+	CPPLIB_COUNT(allocations, _row_size + (_row_size != 0));
+	CPPLIB_COUNT(bytes_allocated, _row_size * (_column_size * sizeof(T) + sizeof(vector<T>)));
 }
 
 template<typename T>
@@ -93,6 +110,10 @@ Matrix<T> ::Matrix(const vector<vector<T>>& other)
 	_row_size = other.size();
 	_column_size = _row_size == 0 ? 0 : other[0].size();
 	matrix = other; 
+	CPPLIB_COUNT(allocations, _row_size + (_row_size != 0));
+	CPPLIB_COUNT(bytes_allocated, _row_size * (_column_size * sizeof(T) + sizeof(vector<T>)));
+	CPPLIB_COUNT(element_copies, _row_size * _column_size);
+	CPPLIB_COUNT(bytes_moved, _row_size * _column_size * sizeof(T));
 }
 
 template<typename T>
@@ -101,10 +122,14 @@ Matrix<T> ::Matrix(const Matrix& other)
 	_row_size = other._row_size;
 	_column_size = other._column_size;
 	matrix = other.matrix; 
+	CPPLIB_COUNT(allocations, _row_size + (_row_size != 0));
+	CPPLIB_COUNT(bytes_allocated, _row_size * (_column_size * sizeof(T) + sizeof(vector<T>)));
+	CPPLIB_COUNT(element_copies, _row_size * _column_size);
+	CPPLIB_COUNT(bytes_moved, _row_size * _column_size * sizeof(T));
 }
 
 template<typename T>
-Matrix<T> ::~Matrix() { matrix.~vector(); }
+Matrix<T> ::~Matrix() {}
 
 template<typename T>
 size_t Matrix<T> ::size() const { return _row_size; }
@@ -117,7 +142,7 @@ void Matrix<T> ::clear()
 {
 	_row_size = 0;
 	_column_size = 0;
-	matrix.~vector(); 
+	matrix.clear();
 }
 
 template<typename T>
@@ -146,6 +171,8 @@ Matrix<T> Matrix<T> ::transpose() const
 {
 	if(_row_size == 0 || _column_size == 0) return Matrix<T>();
 	Matrix<T> _return_matrix(_column_size, _row_size);
+	CPPLIB_COUNT(element_copies, _row_size * _column_size);
+	CPPLIB_COUNT(bytes_moved, _row_size * _column_size * sizeof(T));
 	for (size_t _row_i = 0; _row_i < _row_size; _row_i++)
 		for (size_t _col_i = 0; _col_i < _column_size; _col_i++)
 			_return_matrix[_col_i][_row_i] = matrix[_row_i][_col_i];
@@ -164,8 +191,7 @@ template<typename T>
 void Matrix<T> ::selfTranspose()
 {
 	Matrix<T> _transposed_matrix = this->transpose();
-	matrix.~vector();
-	matrix = _transposed_matrix;
+	matrix = std::move(_transposed_matrix.matrix);
 	std::swap(_row_size, _column_size);
 }
 
@@ -178,19 +204,25 @@ vector<T>& Matrix<T> ::operator[](size_t index) { return matrix[index]; }
 template<typename T>
 void Matrix<T> ::operator=(const vector<vector<T>>& other)
 {
-	matrix.~vector();
 	_row_size = other.size();
 	_column_size = _row_size == 0 ? 0 : other[0].size();
 	matrix = other;
+	CPPLIB_COUNT(allocations, _row_size + (_row_size != 0));
+	CPPLIB_COUNT(bytes_allocated, _row_size * (_column_size * sizeof(T) + sizeof(vector<T>)));
+	CPPLIB_COUNT(element_copies, _row_size * _column_size);
+	CPPLIB_COUNT(bytes_moved, _row_size * _column_size * sizeof(T));
 }
 
 template<typename T>
 void Matrix<T> ::operator=(const Matrix<T>& other)
 {
-	matrix.~vector();
 	_row_size = other.size();
 	_column_size = _row_size == 0 ? 0 : other[0].size();
 	matrix = other.matrix;
+	CPPLIB_COUNT(allocations, _row_size + (_row_size != 0));
+	CPPLIB_COUNT(bytes_allocated, _row_size * (_column_size * sizeof(T) + sizeof(vector<T>)));
+	CPPLIB_COUNT(element_copies, _row_size * _column_size);
+	CPPLIB_COUNT(bytes_moved, _row_size * _column_size * sizeof(T));
 }
 
 template<typename T>
@@ -202,6 +234,7 @@ Matrix<T> Matrix<T> ::operator+(const Matrix<T>& other) const
 {
 	if (_row_size != other._row_size || _column_size != other._column_size) return Matrix<T>();
 	Matrix<T> _return_matrix(_row_size, _column_size);
+	CPPLIB_COUNT(matrix_flops, _row_size * _column_size);
 	for (size_t _row_i = 0; _row_i < _row_size; _row_i++)
 		for (size_t _col_i = 0; _col_i < _column_size; _col_i++)
 			_return_matrix[_row_i][_col_i] = matrix[_row_i][_col_i] + other.matrix[_row_i][_col_i];
@@ -213,6 +246,7 @@ Matrix<T> Matrix<T> ::operator-(const Matrix<T>& other) const
 {
 	if (_row_size != other._row_size || _column_size != other._column_size) return Matrix<T>();
 	Matrix<T> _return_matrix(_row_size, _column_size);
+	CPPLIB_COUNT(matrix_flops, _row_size * _column_size);
 	for (size_t _row_i = 0; _row_i < _row_size; _row_i++)
 		for (size_t _col_i = 0; _col_i < _column_size; _col_i++)
 			_return_matrix[_row_i][_col_i] = matrix[_row_i][_col_i] - other.matrix[_row_i][_col_i];
@@ -223,7 +257,9 @@ template<typename T>
 Matrix<T> Matrix<T> ::operator*(const Matrix<T>& other) const
 {
 	if (_column_size != other._row_size) return Matrix<T>();
+	CPPLIB_SCOPE("Matrix::operator*");
 	Matrix<T> _return_matrix(_row_size, other._column_size);
+	CPPLIB_COUNT(matrix_flops, 2 * _row_size * _column_size * other._column_size);
 	for (size_t _row_i = 0; _row_i < _row_size; _row_i++)
 		for (size_t _col_i = 0; _col_i < other._column_size; _col_i++)
 			for(size_t _mid_i = 0; _mid_i < _column_size; _mid_i++)
@@ -234,6 +270,7 @@ Matrix<T> Matrix<T> ::operator*(const Matrix<T>& other) const
 template <typename T>
 Matrix<T> Matrix<T> :: operator^(long long _power) {
 	if (_row_size != _column_size) return Matrix<T>();
+	CPPLIB_SCOPE("Matrix::operator^");
 	Matrix<T> _result_matrix = getIdentity(_row_size, _column_size);
 	Matrix<T> _helper_matrix(matrix);
 	for (; _power > 0; _power >>= 1, _helper_matrix *= _helper_matrix)
@@ -245,6 +282,7 @@ template<typename T>
 void Matrix<T> ::operator+=(const Matrix<T>& other)
 {
 	if (_row_size != other._row_size || _column_size != other._column_size) return;
+	CPPLIB_COUNT(matrix_flops, _row_size * _column_size);
 	for (size_t _row_i = 0; _row_i < _row_size; _row_i++)
 		for (size_t _col_i = 0; _col_i < _column_size; _col_i++)
 			matrix[_row_i][_col_i] += other.matrix[_row_i][_col_i];
@@ -254,6 +292,7 @@ template<typename T>
 void Matrix<T> ::operator-=(const Matrix<T>& other)
 {
 	if (_row_size != other._row_size || _column_size != other._column_size) return;
+	CPPLIB_COUNT(matrix_flops, _row_size * _column_size);
 	for (size_t _row_i = 0; _row_i < _row_size; _row_i++)
 		for (size_t _col_i = 0; _col_i < _column_size; _col_i++)
 			matrix[_row_i][_col_i] -= other.matrix[_row_i][_col_i];
@@ -264,12 +303,12 @@ void Matrix<T> ::operator*=(const Matrix<T>& other)
 {
 	if (_column_size != other._row_size) return;
 	Matrix<T> _helper_matrix = *this * other;
-	matrix.~vector();
 	matrix = std::move(_helper_matrix.matrix);
 }
 
 template <typename T>
 void Matrix<T> ::operator^=(long long _power) {
+	CPPLIB_SCOPE("Matrix::operator^=");
 	Matrix<T> _result_matrix = getIdentity(_row_size, _column_size);
 	Matrix<T> _helper_matrix(matrix);
 	for (; _power > 0; _power >>= 1, _helper_matrix *= _helper_matrix)
@@ -295,4 +334,246 @@ std::ostream& operator <<(std::ostream& _ostream, const Matrix<T>& _matrix)
 		_ostream << '\n';
 	}
 	return _ostream;
-}
\ No newline at end of file
+}
+
+
+// Statically sized matrix for small kernels such as transforms and recurrences. Elements
+// live inline, so nothing allocates; arithmetic is unrolled over the compile-time extents
+// and usable in constant expressions; mismatched dimensions fail to compile. Converts
+// implicitly to Matrix<T> and explicitly back, the latter checking the size at run time.
+template<typename T, size_t R, size_t C>
+class Matrix
+{
+	static_assert(R > 0 && C > 0, "Fixed size matrices need at least one row and one column");
+
+public:
+	typedef T Row[C];
+
+	constexpr Matrix();
+	constexpr explicit Matrix(const T&);
+	constexpr Matrix(std::initializer_list<std::initializer_list<T>>);
+	explicit Matrix(const Matrix<T>&);
+
+	static constexpr size_t size() { return R; }
+	static constexpr size_t rsize() { return C; }
+	constexpr void fill(const T&);
+	vector<size_t> dimensions() const { return { R, C }; }
+
+	constexpr Matrix<T, C, R> transpose() const;
+	constexpr void selfIdentity();
+	constexpr void selfTranspose();
+
+	constexpr const Row& operator [](size_t) const;
+	constexpr Row& operator [](size_t);
+
+	operator Matrix<T>() const;
+	constexpr bool operator ==(const Matrix&) const;
+
+	constexpr Matrix operator +(const Matrix&) const;
+	constexpr Matrix operator -(const Matrix&) const;
+	template<size_t K>
+	constexpr Matrix<T, R, K> operator *(const Matrix<T, C, K>&) const;
+	constexpr Matrix operator ^(long long) const;
+
+	constexpr void operator +=(const Matrix&);
+	constexpr void operator -=(const Matrix&);
+	constexpr void operator *=(const Matrix<T, C, C>&);
+	constexpr void operator ^=(long long);
+
+	static constexpr Matrix getIdentity()
+	{
+		Matrix _return_matrix;
+		_return_matrix.selfIdentity();
+		return _return_matrix;
+	}
+
+	static constexpr Matrix getZeros() { return Matrix(); }
+
+private:
+	T matrix[R][C];
+
+	template<typename Operation, size_t... _indices>
+	static constexpr Matrix combine(const Matrix&, const Matrix&, Operation, std::index_sequence<_indices...>);
+	template<size_t K, size_t... _indices>
+	constexpr Matrix<T, R, K> multiply(const Matrix<T, C, K>&, std::index_sequence<_indices...>) const;
+	template<size_t K, size_t... _mid_indices>
+	constexpr T dot(const Matrix<T, C, K>&, size_t, size_t, std::index_sequence<_mid_indices...>) const;
+	template<size_t... _indices>
+	constexpr Matrix<T, C, R> transposed(std::index_sequence<_indices...>) const;
+};
+
+template<typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C> ::Matrix() : matrix{} {}
+
+template<typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C> ::Matrix(const T& value) : matrix{} { fill(value); }
+
+template<typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C> ::Matrix(std::initializer_list<std::initializer_list<T>> values) : matrix{}
+{
+	if (values.size() != R) throw std::runtime_error("Initializer does not match the matrix dimensions");
+	size_t _row_i = 0;
+	for (const std::initializer_list<T>& _row : values) {
+		if (_row.size() != C) throw std::runtime_error("Initializer does not match the matrix dimensions");
+		size_t _col_i = 0;
+		for (const T& _value : _row)
+			matrix[_row_i][_col_i++] = _value;
+		_row_i++;
+	}
+}
+
+template<typename T, size_t R, size_t C>
+Matrix<T, R, C> ::Matrix(const Matrix<T>& other) : matrix{}
+{
+	if (other.size() != R || other.rsize() != C) throw std::runtime_error("Matrix dimensions do not match");
+	for (size_t _row_i = 0; _row_i < R; _row_i++)
+		for (size_t _col_i = 0; _col_i < C; _col_i++)
+			matrix[_row_i][_col_i] = other[_row_i][_col_i];
+}
+
+template<typename T, size_t R, size_t C>
+constexpr void Matrix<T, R, C> ::fill(const T& value)
+{
+	for (size_t _row_i = 0; _row_i < R; _row_i++)
+		for (size_t _col_i = 0; _col_i < C; _col_i++)
+			matrix[_row_i][_col_i] = value;
+}
+
+template<typename T, size_t R, size_t C>
+constexpr Matrix<T, C, R> Matrix<T, R, C> ::transpose() const { return transposed(std::make_index_sequence<R * C>()); }
+
+template<typename T, size_t R, size_t C>
+constexpr void Matrix<T, R, C> ::selfIdentity()
+{
+	for (size_t _row_i = 0; _row_i < R; _row_i++)
+		for (size_t _col_i = 0; _col_i < C; _col_i++)
+			matrix[_row_i][_col_i] = (_row_i == _col_i);
+}
+
+template<typename T, size_t R, size_t C>
+constexpr void Matrix<T, R, C> ::selfTranspose()
+{
+	static_assert(R == C, "Only square matrices can be transposed in place");
+	*this = transpose();
+}
+
+template<typename T, size_t R, size_t C>
+constexpr const typename Matrix<T, R, C>::Row& Matrix<T, R, C> ::operator[](size_t index) const { return matrix[index]; }
+
+template<typename T, size_t R, size_t C>
+constexpr typename Matrix<T, R, C>::Row& Matrix<T, R, C> ::operator[](size_t index) { return matrix[index]; }
+
+template<typename T, size_t R, size_t C>
+Matrix<T, R, C> ::operator Matrix<T>() const
+{
+	Matrix<T> _return_matrix(R, C);
+	for (size_t _row_i = 0; _row_i < R; _row_i++)
+		for (size_t _col_i = 0; _col_i < C; _col_i++)
+			_return_matrix[_row_i][_col_i] = matrix[_row_i][_col_i];
+	return _return_matrix;
+}
+
+template<typename T, size_t R, size_t C>
+constexpr bool Matrix<T, R, C> ::operator==(const Matrix& other) const
+{
+	for (size_t _row_i = 0; _row_i < R; _row_i++)
+		for (size_t _col_i = 0; _col_i < C; _col_i++)
+			if (!(matrix[_row_i][_col_i] == other.matrix[_row_i][_col_i])) return false;
+	return true;
+}
+
+template<typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C> Matrix<T, R, C> ::operator+(const Matrix& other) const
+{ return combine(*this, other, std::plus<T>(), std::make_index_sequence<R * C>()); }
+
+template<typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C> Matrix<T, R, C> ::operator-(const Matrix& other) const
+{ return combine(*this, other, std::minus<T>(), std::make_index_sequence<R * C>()); }
+
+template<typename T, size_t R, size_t C>
+template<size_t K>
+constexpr Matrix<T, R, K> Matrix<T, R, C> ::operator*(const Matrix<T, C, K>& other) const
+{ return multiply(other, std::make_index_sequence<R * K>()); }
+
+// Squares the base only while bits of the exponent remain, so computing a power never
+// evaluates a product beyond the result (which would overflow in constant evaluation).
+template<typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C> Matrix<T, R, C> ::operator^(long long _power) const
+{
+	static_assert(R == C, "Only square matrices can be raised to a power");
+	Matrix _result_matrix = getIdentity();
+	Matrix _helper_matrix = *this;
+	while (_power > 0) {
+		if (_power & 1) _result_matrix = _result_matrix * _helper_matrix;
+		_power >>= 1;
+		if (_power > 0) _helper_matrix = _helper_matrix * _helper_matrix;
+	}
+	return _result_matrix;
+}
+
+template<typename T, size_t R, size_t C>
+constexpr void Matrix<T, R, C> ::operator+=(const Matrix& other) { *this = *this + other; }
+
+template<typename T, size_t R, size_t C>
+constexpr void Matrix<T, R, C> ::operator-=(const Matrix& other) { *this = *this - other; }
+
+template<typename T, size_t R, size_t C>
+constexpr void Matrix<T, R, C> ::operator*=(const Matrix<T, C, C>& other) { *this = *this * other; }
+
+template<typename T, size_t R, size_t C>
+constexpr void Matrix<T, R, C> ::operator^=(long long _power) { *this = *this ^ _power; }
+
+template<typename T, size_t R, size_t C>
+template<typename Operation, size_t... _indices>
+constexpr Matrix<T, R, C> Matrix<T, R, C> ::combine(const Matrix& first, const Matrix& second, Operation operation,
+	std::index_sequence<_indices...>)
+{
+	Matrix _return_matrix;
+	((_return_matrix.matrix[_indices / C][_indices % C] =
+		operation(first.matrix[_indices / C][_indices % C], second.matrix[_indices / C][_indices % C])), ...);
+	return _return_matrix;
+}
+
+template<typename T, size_t R, size_t C>
+template<size_t K, size_t... _indices>
+constexpr Matrix<T, R, K> Matrix<T, R, C> ::multiply(const Matrix<T, C, K>& other, std::index_sequence<_indices...>) const
+{
+	Matrix<T, R, K> _return_matrix;
+	((_return_matrix[_indices / K][_indices % K] = dot(other, _indices / K, _indices % K, std::make_index_sequence<C>())), ...);
+	return _return_matrix;
+}
+
+template<typename T, size_t R, size_t C>
+template<size_t K, size_t... _mid_indices>
+constexpr T Matrix<T, R, C> ::dot(const Matrix<T, C, K>& other, size_t _row_i, size_t _col_i,
+	std::index_sequence<_mid_indices...>) const
+{ return ((T)0 + ... + (matrix[_row_i][_mid_indices] * other[_mid_indices][_col_i])); }
+
+template<typename T, size_t R, size_t C>
+template<size_t... _indices>
+constexpr Matrix<T, C, R> Matrix<T, R, C> ::transposed(std::index_sequence<_indices...>) const
+{
+	Matrix<T, C, R> _return_matrix;
+	((_return_matrix[_indices % C][_indices / C] = matrix[_indices / C][_indices % C]), ...);
+	return _return_matrix;
+}
+
+template <typename T, size_t R, size_t C>
+std::istream& operator >>(std::istream& _istream, Matrix<T, R, C>& _matrix)
+{
+	for (size_t _row_i = 0; _row_i < R; _row_i++)
+		for (size_t _col_i = 0; _col_i < C; _col_i++)
+			_istream >> _matrix[_row_i][_col_i];
+	return _istream;
+}
+
+template <typename T, size_t R, size_t C>
+std::ostream& operator <<(std::ostream& _ostream, const Matrix<T, R, C>& _matrix)
+{
+	for (size_t _row_i = 0; _row_i < R; _row_i++) {
+		for (size_t _col_i = 0; _col_i < C; _col_i++)
+			_ostream << _matrix[_row_i][_col_i] << ' ';
+		_ostream << '\n';
+	}
+	return _ostream;
+}
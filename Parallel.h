@@ -0,0 +1,57 @@
+#pragma once
+
+// Thread splitting shared by the graph headers. Work is cut into blocks of `grain`
+// items that workers claim dynamically, so skewed blocks (hub vertices, long lines) do
+// not leave the other workers idle; fewer than two blocks run on the calling thread.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace cpplib_detail
+{
+	const size_t PARALLEL_BLOCK = 1024;
+
+	// Workers used for `count` items in blocks of `grain`; bounds the `worker` argument
+	// passed to the parallel_blocks body.
+	inline size_t worker_count(size_t count, size_t grain)
+	{
+		size_t _threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+		return std::min(_threads, std::max<size_t>(1, count / std::max<size_t>(1, grain)));
+	}
+
+	// Runs body(worker, begin, end) over [0, count) and returns the worker count.
+	template<typename Function>
+	size_t parallel_blocks(size_t count, size_t grain, Function body)
+	{
+		grain = std::max<size_t>(1, grain);
+		size_t _workers = worker_count(count, grain);
+		if (_workers == 1) {
+			body((size_t)0, (size_t)0, count);
+			return 1;
+		}
+
+		std::atomic<size_t> _next_block(0);
+		std::vector<std::thread> _threads;
+		for (size_t _worker = 0; _worker < _workers; _worker++)
+			_threads.emplace_back([&, _worker] {
+				for (size_t _begin = _next_block.fetch_add(grain); _begin < count; _begin = _next_block.fetch_add(grain))
+					body(_worker, _begin, std::min(_begin + grain, count));
+			});
+		for (std::thread& _thread : _threads)
+			_thread.join();
+		return _workers;
+	}
+
+	// Runs body(i) for every i in [0, count).
+	template<typename Function>
+	void parallel_for(size_t count, size_t grain, Function body)
+	{
+		parallel_blocks(count, grain, [&body](size_t, size_t _begin, size_t _end) {
+			for (size_t _i = _begin; _i < _end; _i++)
+				body(_i);
+		});
+	}
+}
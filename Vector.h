@@ -2,6 +2,7 @@
 // @Author : Darshit Nasit
 
 #include<iostream>
+#include "Instrument.h"
 
 template<typename Vector>
 class Vector_Iterator
@@ -102,6 +103,8 @@ Vector<T> ::Vector(size_t v_size)
 	vector_size = v_size;
 	vector_capacity = v_size;
 	vector_data = new T[v_size];
+	CPPLIB_COUNT(allocations, 1);
+	CPPLIB_COUNT(bytes_allocated, v_size * sizeof(T));
 }
 
 template<typename T>
@@ -110,6 +113,10 @@ Vector<T> ::Vector(size_t v_size, const T& value)
 	vector_size = v_size;
 	vector_capacity = v_size;
 	vector_data = new T[v_size];
+	CPPLIB_COUNT(allocations, 1);
+	CPPLIB_COUNT(bytes_allocated, v_size * sizeof(T));
+	CPPLIB_COUNT(element_copies, v_size);
+	CPPLIB_COUNT(bytes_moved, v_size * sizeof(T));
 	for (size_t i = 0; i < v_size; i++)
 		vector_data[i] = value;
 }
@@ -120,6 +127,10 @@ Vector<T> ::Vector(size_t v_size, T&& value)
 	vector_size = v_size;
 	vector_capacity = v_size;
 	vector_data = new T[v_size];
+	CPPLIB_COUNT(allocations, 1);
+	CPPLIB_COUNT(bytes_allocated, v_size * sizeof(T));
+	CPPLIB_COUNT(element_copies, v_size);
+	CPPLIB_COUNT(bytes_moved, v_size * sizeof(T));
 	for (size_t i = 0; i < v_size; i++)
 		vector_data[i] = value;
 }
@@ -130,6 +141,10 @@ Vector<T> ::Vector(const Vector<T>& other)
 	vector_size = other.vector_size;
 	vector_capacity = other.vector_capacity;
 	vector_data = new T[vector_capacity];
+	CPPLIB_COUNT(allocations, 1);
+	CPPLIB_COUNT(bytes_allocated, vector_capacity * sizeof(T));
+	CPPLIB_COUNT(element_copies, vector_size);
+	CPPLIB_COUNT(bytes_moved, vector_size * sizeof(T));
 	for (size_t i = 0; i < vector_size; i++)
 		vector_data[i] = other[i];
 }
@@ -142,6 +157,10 @@ Vector<T> ::Vector(std::initializer_list<T>&& init)
 		vector_size = v_size;
 		vector_capacity = v_size;
 		vector_data = new T[v_size];
+		CPPLIB_COUNT(allocations, 1);
+		CPPLIB_COUNT(bytes_allocated, v_size * sizeof(T));
+		CPPLIB_COUNT(element_copies, v_size);
+		CPPLIB_COUNT(bytes_moved, v_size * sizeof(T));
 		for (const T* it = init.begin(); it != init.end(); it++)
 			vector_data[it-init.begin()] = std::move(*it);
 	}
@@ -156,6 +175,11 @@ void Vector<T> ::reAllocate(size_t capacity)
 	T* new_vector_data = nullptr;
 	if (capacity != 0) {
 		new_vector_data = new T[capacity];
+		CPPLIB_COUNT(allocations, 1);
+		CPPLIB_COUNT(bytes_allocated, capacity * sizeof(T));
+		CPPLIB_COUNT(reallocations, vector_data != nullptr);
+		CPPLIB_COUNT(element_moves, vector_size);
+		CPPLIB_COUNT(bytes_moved, vector_size * sizeof(T));
 		for (size_t i = 0; i < vector_size; i++)
 			new_vector_data[i] = std::move(vector_data[i]);
 	}
@@ -229,6 +253,8 @@ void Vector<T> ::push_back(const T& value)
 		reAllocate(INITIAL_CAPACITY);
 	if (vector_size >= vector_capacity)
 		reAllocate(increaseCapacity());
+	CPPLIB_COUNT(element_copies, 1);
+	CPPLIB_COUNT(bytes_moved, sizeof(T));
 	vector_data[vector_size++] = value;
 }
 
@@ -239,6 +265,8 @@ void Vector<T> ::push_back(T&& value)
 		reAllocate(INITIAL_CAPACITY);
 	if (vector_size >= vector_capacity)
 		reAllocate(increaseCapacity());
+	CPPLIB_COUNT(element_moves, 1);
+	CPPLIB_COUNT(bytes_moved, sizeof(T));
 	vector_data[vector_size++] = std::move(value);
 }
 
@@ -250,6 +278,8 @@ void Vector<T> ::emplace_back(Args&&... args)
 		reAllocate(INITIAL_CAPACITY);
 	if (vector_size >= vector_capacity)
 		reAllocate(increaseCapacity());
+	CPPLIB_COUNT(element_moves, 1);
+	CPPLIB_COUNT(bytes_moved, sizeof(T));
 	vector_data[vector_size++] = T(std::forward<Args>(args)...);
 }
 
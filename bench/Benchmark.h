@@ -0,0 +1,329 @@
+#pragma once
+
+// Benchmark harness for the suites in this directory. When the build finds Google
+// Benchmark (CPPLIB_HAVE_GOOGLE_BENCHMARK) it is used directly; otherwise this header
+// provides the subset of its API the suites use, with the same command line flags
+// (--benchmark_filter, --benchmark_min_time, --benchmark_format, --benchmark_out,
+// --benchmark_out_format) and the same JSON layout, so results from either can be
+// compared with the same tooling.
+
+#ifdef CPPLIB_HAVE_GOOGLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#else
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace benchmark
+{
+	enum TimeUnit { kNanosecond, kMicrosecond, kMillisecond, kSecond };
+
+	template<typename Type>
+	inline void DoNotOptimize(Type&& value)
+	{
+#ifdef _MSC_VER
+		static volatile const void* sink;
+		sink = &value;
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	inline void ClobberMemory()
+	{
+#ifdef _MSC_VER
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : : "memory");
+#endif
+	}
+
+	class State
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		// Loop variable of `for (auto _ : state)`. Its user-provided constructor and
+		// destructor keep -Wunused-variable quiet, as with Google Benchmark.
+		struct Value
+		{
+			Value() {}
+			~Value() {}
+		};
+
+		struct Iterator
+		{
+			State* state;
+			int64_t remaining;
+
+			bool operator !=(const Iterator&)
+			{
+				if (remaining-- > 0) return true;
+				state->PauseTiming();
+				return false;
+			}
+			void operator ++() {}
+			Value operator *() const { return Value(); }
+		};
+
+		State(const std::vector<int64_t>& arguments, int64_t iterations) : arguments(arguments), max_iterations(iterations) {}
+
+		Iterator begin()
+		{
+			ResumeTiming();
+			return Iterator{ this, max_iterations };
+		}
+		Iterator end() { return Iterator{ this, 0 }; }
+
+		int64_t range(size_t index = 0) const { return arguments.at(index); }
+		int64_t iterations() const { return max_iterations; }
+
+		void PauseTiming()
+		{
+			if (!running) return;
+			real_seconds += std::chrono::duration<double>(Clock::now() - real_start).count();
+			cpu_seconds += (double)(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+			running = false;
+		}
+
+		void ResumeTiming()
+		{
+			if (running) return;
+			real_start = Clock::now();
+			cpu_start = std::clock();
+			running = true;
+		}
+
+		void SetItemsProcessed(int64_t items) { items_processed = items; }
+		void SetBytesProcessed(int64_t bytes) { bytes_processed = bytes; }
+		void SetLabel(const std::string& text) { label = text; }
+
+		std::map<std::string, double> counters;
+
+	private:
+		friend class Runner;
+
+		std::vector<int64_t> arguments;
+		int64_t max_iterations;
+		bool running = false;
+		Clock::time_point real_start;
+		std::clock_t cpu_start = 0;
+		double real_seconds = 0, cpu_seconds = 0;
+		int64_t items_processed = 0, bytes_processed = 0;
+		std::string label;
+	};
+
+	class Benchmark
+	{
+	public:
+		Benchmark(const std::string& name, void (*function)(State&)) : name(name), function(function) {}
+
+		Benchmark* Arg(int64_t value) { argument_sets.push_back({ value }); return this; }
+		Benchmark* Args(std::initializer_list<int64_t> values) { argument_sets.push_back(values); return this; }
+		Benchmark* Unit(TimeUnit unit) { time_unit = unit; return this; }
+
+	private:
+		friend class Runner;
+
+		std::string name;
+		void (*function)(State&);
+		std::vector<std::vector<int64_t>> argument_sets;
+		TimeUnit time_unit = kNanosecond;
+	};
+
+	class Runner
+	{
+	public:
+		static std::vector<std::unique_ptr<Benchmark>>& registry()
+		{
+			static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+			return benchmarks;
+		}
+
+		static Benchmark* add(const char* name, void (*function)(State&))
+		{
+			registry().emplace_back(new Benchmark(name, function));
+			return registry().back().get();
+		}
+
+		static int run(int argc, char** argv);
+
+	private:
+		struct Result
+		{
+			std::string name;
+			int64_t iterations;
+			double real_time, cpu_time;
+			TimeUnit time_unit;
+			State state;
+		};
+
+		static double scale(TimeUnit unit) { return unit == kNanosecond ? 1e9 : unit == kMicrosecond ? 1e6 : unit == kMillisecond ? 1e3 : 1; }
+		static const char* unit_name(TimeUnit unit) { return unit == kNanosecond ? "ns" : unit == kMicrosecond ? "us" : unit == kMillisecond ? "ms" : "s"; }
+		static Result measure(const Benchmark&, const std::vector<int64_t>&, const std::string&, double);
+		static void write_console_header(std::ostream&);
+		static void write_console_row(std::ostream&, const Result&);
+		static void write_json(std::ostream&, const std::vector<Result>&, const char*);
+	};
+
+	// Grows the iteration count like Google Benchmark does until one run lasts at
+	// least min_time seconds, and reports that run.
+	inline Runner::Result Runner::measure(const Benchmark& benchmark, const std::vector<int64_t>& arguments, const std::string& name, double min_time)
+	{
+		int64_t iterations = 1;
+		for (;;) {
+			State state(arguments, iterations);
+			benchmark.function(state);
+			state.PauseTiming();
+			if (state.real_seconds >= min_time || iterations >= 1000000000) {
+				double unit = scale(benchmark.time_unit);
+				return Result{ name, iterations, state.real_seconds * unit / iterations, state.cpu_seconds * unit / iterations, benchmark.time_unit, state };
+			}
+			double multiplier = state.real_seconds <= 0 ? 10.0 : std::min(10.0, min_time * 1.4 / state.real_seconds);
+			iterations = std::max(iterations + 1, (int64_t)(iterations * multiplier));
+		}
+	}
+
+	inline void Runner::write_console_header(std::ostream& output)
+	{
+		char line[256];
+		snprintf(line, sizeof(line), "%-48s %15s %15s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+		output << line << std::string(93, '-') << '\n';
+	}
+
+	inline void Runner::write_console_row(std::ostream& output, const Result& result)
+	{
+		char line[256];
+		snprintf(line, sizeof(line), "%-48s %12.0f %-2s %12.0f %-2s %12lld", result.name.c_str(), result.real_time, unit_name(result.time_unit),
+			result.cpu_time, unit_name(result.time_unit), (long long)result.iterations);
+		output << line;
+		for (const auto& [counter, value] : result.state.counters)
+			output << ' ' << counter << '=' << value;
+		if (!result.state.label.empty())
+			output << ' ' << result.state.label;
+		output << '\n';
+	}
+
+	inline void Runner::write_json(std::ostream& output, const std::vector<Result>& results, const char* executable)
+	{
+		char date[64];
+		std::time_t now = std::time(nullptr);
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+		output << "{\n  \"context\": {\n";
+		output << "    \"date\": \"" << date << "\",\n";
+		output << "    \"executable\": \"" << executable << "\",\n";
+		output << "    \"num_cpus\": " << std::max(1u, std::thread::hardware_concurrency()) << ",\n";
+#ifdef NDEBUG
+		output << "    \"library_build_type\": \"release\"\n";
+#else
+		output << "    \"library_build_type\": \"debug\"\n";
+#endif
+		output << "  },\n  \"benchmarks\": [";
+		for (size_t i = 0; i < results.size(); i++) {
+			const Result& result = results[i];
+			double seconds = result.real_time / scale(result.time_unit);
+			output << (i == 0 ? "\n" : ",\n") << "    {\n";
+			output << "      \"name\": \"" << result.name << "\",\n";
+			output << "      \"run_name\": \"" << result.name << "\",\n";
+			output << "      \"run_type\": \"iteration\",\n";
+			output << "      \"iterations\": " << result.iterations << ",\n";
+			output << "      \"real_time\": " << result.real_time << ",\n";
+			output << "      \"cpu_time\": " << result.cpu_time << ",\n";
+			output << "      \"time_unit\": \"" << unit_name(result.time_unit) << "\"";
+			if (result.state.items_processed != 0)
+				output << ",\n      \"items_per_second\": " << result.state.items_processed / (seconds * result.iterations);
+			if (result.state.bytes_processed != 0)
+				output << ",\n      \"bytes_per_second\": " << result.state.bytes_processed / (seconds * result.iterations);
+			if (!result.state.label.empty())
+				output << ",\n      \"label\": \"" << result.state.label << "\"";
+			for (const auto& [counter, value] : result.state.counters)
+				output << ",\n      \"" << counter << "\": " << value;
+			output << "\n    }";
+		}
+		output << "\n  ]\n}\n";
+	}
+
+	inline int Runner::run(int argc, char** argv)
+	{
+		std::string filter = ".", format = "console", out, out_format = "json";
+		double min_time = 0.5;
+		for (int i = 1; i < argc; i++) {
+			std::string argument = argv[i];
+			auto value = [&](const char* flag) {
+				std::string prefix = std::string("--") + flag + "=";
+				return argument.compare(0, prefix.size(), prefix) == 0 ? argument.substr(prefix.size()) : std::string("\x01");
+			};
+			if (value("benchmark_filter") != "\x01") filter = value("benchmark_filter");
+			else if (value("benchmark_min_time") != "\x01") min_time = std::atof(value("benchmark_min_time").c_str());
+			else if (value("benchmark_format") != "\x01") format = value("benchmark_format");
+			else if (value("benchmark_out") != "\x01") out = value("benchmark_out");
+			else if (value("benchmark_out_format") != "\x01") out_format = value("benchmark_out_format");
+			else {
+				std::cerr << "unrecognized argument " << argument << '\n';
+				return 1;
+			}
+		}
+
+		std::regex pattern(filter);
+		std::vector<Result> results;
+		if (format == "console")
+			write_console_header(std::cout);
+		for (const std::unique_ptr<Benchmark>& benchmark : registry()) {
+			std::vector<std::vector<int64_t>> argument_sets = benchmark->argument_sets;
+			if (argument_sets.empty())
+				argument_sets.push_back({});
+			for (const std::vector<int64_t>& arguments : argument_sets) {
+				std::string name = benchmark->name;
+				for (int64_t argument : arguments)
+					name += "/" + std::to_string(argument);
+				if (!std::regex_search(name, pattern))
+					continue;
+				results.push_back(measure(*benchmark, arguments, name, min_time));
+				if (format == "console")
+					write_console_row(std::cout, results.back());
+			}
+		}
+
+		if (format == "json")
+			write_json(std::cout, results, argv[0]);
+		if (!out.empty()) {
+			std::ofstream file(out);
+			if (out_format == "json") write_json(file, results, argv[0]);
+			else {
+				write_console_header(file);
+				for (const Result& result : results)
+					write_console_row(file, result);
+			}
+		}
+		return 0;
+	}
+}
+
+#define BENCHMARK_CONCAT_(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_(a, b)
+#define BENCHMARK(function) \
+	static ::benchmark::Benchmark* BENCHMARK_CONCAT(benchmark_registration_, __LINE__) = ::benchmark::Runner::add(#function, function)
+#define BENCHMARK_MAIN() \
+	int main(int argc, char** argv) { return ::benchmark::Runner::run(argc, argv); }
+
+#endif
@@ -0,0 +1,210 @@
+// Graph insertion, edge lookup, component counting and traversal on synthetic RMAT,
+// grid and path graphs, against flat adjacency-list / CSR baselines.
+//
+// Every benchmark takes { kind, size }: kind 0 is RMAT with 2^size vertices and edge
+// factor 8, kind 1 a size x size grid and kind 2 a path of `size` vertices.
+
+#include "Benchmark.h"
+#include "GraphGenerators.h"
+
+enum Graph_Kind { RMAT, GRID, PATH };
+
+#define GRAPH_SHAPES ->Args({ RMAT, 10 })->Args({ RMAT, 14 })->Args({ GRID, 32 })->Args({ GRID, 128 })->Args({ PATH, 1024 })->Args({ PATH, 8192 })
+
+// Edge lists without self loops or repeated edges, so that insert_edge never throws.
+static const vector<Edge<uint32_t> >& synthetic_edges(int64_t kind, int64_t size) {
+	static map<pair<int64_t, int64_t>, vector<Edge<uint32_t> > > cache;
+	auto cached = cache.find({ kind, size });
+	if (cached != cache.end())
+		return cached->second;
+
+	vector<Edge<uint32_t> > edges = kind == RMAT ? rmat_edges((int)size, 8, 42) : kind == GRID ? grid_edges((uint32_t)size) : path_edges((uint32_t)size);
+	vector<pair<uint32_t, uint32_t> > pairs;
+	for (const Edge<uint32_t>& edge : edges)
+		if (edge.getFirst() != edge.getSecond())
+			pairs.emplace_back(min(edge.getFirst(), edge.getSecond()), max(edge.getFirst(), edge.getSecond()));
+	sort(pairs.begin(), pairs.end());
+	pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+
+	vector<Edge<uint32_t> > unique_edges;
+	for (auto& [first, second] : pairs)
+		unique_edges.emplace_back(first, second);
+	return cache[{ kind, size }] = unique_edges;
+}
+
+static uint32_t node_bound(const vector<Edge<uint32_t> >& edges) {
+	uint32_t bound = 0;
+	for (const Edge<uint32_t>& edge : edges)
+		bound = max(bound, max(edge.getFirst(), edge.getSecond()) + 1);
+	return bound;
+}
+
+static Graph<uint32_t> build_graph(const vector<Edge<uint32_t> >& edges) {
+	Graph<uint32_t> graph;
+	graph.build_from_edge_list(edges);
+	return graph;
+}
+
+static vector<vector<uint32_t> > adjacency_list(const vector<Edge<uint32_t> >& edges) {
+	vector<vector<uint32_t> > adjacency(node_bound(edges));
+	for (const Edge<uint32_t>& edge : edges) {
+		adjacency[edge.getFirst()].push_back(edge.getSecond());
+		adjacency[edge.getSecond()].push_back(edge.getFirst());
+	}
+	for (vector<uint32_t>& adjacent : adjacency)
+		sort(adjacent.begin(), adjacent.end());
+	return adjacency;
+}
+
+static void label_graph(benchmark::State& state, const vector<Edge<uint32_t> >& edges) {
+	const char* kinds[] = { "rmat", "grid", "path" };
+	state.SetLabel(string(kinds[state.range(0)]) + " " + to_string(node_bound(edges)) + "v " + to_string(edges.size()) + "e");
+	state.SetItemsProcessed(state.iterations() * (int64_t)edges.size());
+}
+
+static void BM_Graph_InsertEdge(benchmark::State& state) {
+	const vector<Edge<uint32_t> >& edges = synthetic_edges(state.range(0), state.range(1));
+	uint32_t nodes = node_bound(edges);
+	for (auto _ : state) {
+		Graph<uint32_t> graph;
+		for (uint32_t node = 0; node < nodes; node++)
+			graph.insert_node(node);
+		for (const Edge<uint32_t>& edge : edges)
+			graph.insert_edge(edge);
+		benchmark::ClobberMemory();
+	}
+	label_graph(state, edges);
+}
+BENCHMARK(BM_Graph_InsertEdge) GRAPH_SHAPES->Unit(benchmark::kMicrosecond);
+
+static void BM_Graph_InsertEdges(benchmark::State& state) {
+	const vector<Edge<uint32_t> >& edges = synthetic_edges(state.range(0), state.range(1));
+	for (auto _ : state) {
+		Graph<uint32_t> graph;
+		Insert_Summary summary = graph.build_from_edge_list(edges);
+		benchmark::DoNotOptimize(summary.inserted);
+	}
+	label_graph(state, edges);
+}
+BENCHMARK(BM_Graph_InsertEdges) GRAPH_SHAPES->Unit(benchmark::kMicrosecond);
+
+static void BM_Baseline_Insert(benchmark::State& state) {
+	const vector<Edge<uint32_t> >& edges = synthetic_edges(state.range(0), state.range(1));
+	for (auto _ : state) {
+		vector<vector<uint32_t> > adjacency = adjacency_list(edges);
+		benchmark::DoNotOptimize(adjacency.data());
+	}
+	label_graph(state, edges);
+}
+BENCHMARK(BM_Baseline_Insert) GRAPH_SHAPES->Unit(benchmark::kMicrosecond);
+
+// Alternates existing edges with pairs of existing vertices that are mostly not joined.
+static vector<pair<uint32_t, uint32_t> > edge_queries(const vector<Edge<uint32_t> >& edges) {
+	mt19937 random(7);
+	vector<pair<uint32_t, uint32_t> > queries;
+	for (size_t i = 0; i < 4096; i++) {
+		const Edge<uint32_t>& edge = edges[random() % edges.size()];
+		queries.emplace_back(edge.getFirst(), edge.getSecond());
+		queries.emplace_back(edges[random() % edges.size()].getFirst(), edges[random() % edges.size()].getSecond());
+	}
+	return queries;
+}
+
+static void BM_Graph_HasEdge(benchmark::State& state) {
+	const vector<Edge<uint32_t> >& edges = synthetic_edges(state.range(0), state.range(1));
+	Graph<uint32_t> graph = build_graph(edges);
+	vector<pair<uint32_t, uint32_t> > queries = edge_queries(edges);
+	for (auto _ : state) {
+		size_t found = 0;
+		for (auto& [first, second] : queries)
+			found += graph.has_edge(first, second);
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * (int64_t)queries.size());
+}
+BENCHMARK(BM_Graph_HasEdge) GRAPH_SHAPES;
+
+static void BM_Baseline_HasEdge(benchmark::State& state) {
+	const vector<Edge<uint32_t> >& edges = synthetic_edges(state.range(0), state.range(1));
+	vector<vector<uint32_t> > adjacency = adjacency_list(edges);
+	vector<pair<uint32_t, uint32_t> > queries = edge_queries(edges);
+	for (auto _ : state) {
+		size_t found = 0;
+		for (auto& [first, second] : queries)
+			found += binary_search(adjacency[first].begin(), adjacency[first].end(), second);
+		benchmark::DoNotOptimize(found);
+	}
+	state.SetItemsProcessed(state.iterations() * (int64_t)queries.size());
+}
+BENCHMARK(BM_Baseline_HasEdge) GRAPH_SHAPES;
+
+static void BM_Graph_Components(benchmark::State& state) {
+	const vector<Edge<uint32_t> >& edges = synthetic_edges(state.range(0), state.range(1));
+	Graph<uint32_t> graph = build_graph(edges);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(graph.total_components());
+	label_graph(state, edges);
+}
+BENCHMARK(BM_Graph_Components) GRAPH_SHAPES->Unit(benchmark::kMicrosecond);
+
+static void BM_Baseline_Components(benchmark::State& state) {
+	const vector<Edge<uint32_t> >& edges = synthetic_edges(state.range(0), state.range(1));
+	uint32_t nodes = node_bound(edges);
+	vector<uint32_t> parent(nodes);
+	for (auto _ : state) {
+		iota(parent.begin(), parent.end(), 0);
+		auto root = [&parent](uint32_t node) {
+			while (parent[node] != node)
+				node = parent[node] = parent[parent[node]];
+			return node;
+		};
+		size_t components = nodes;
+		for (const Edge<uint32_t>& edge : edges) {
+			uint32_t first = root(edge.getFirst()), second = root(edge.getSecond());
+			if (first != second) {
+				parent[first] = second;
+				components--;
+			}
+		}
+		benchmark::DoNotOptimize(components);
+	}
+	label_graph(state, edges);
+}
+BENCHMARK(BM_Baseline_Components) GRAPH_SHAPES->Unit(benchmark::kMicrosecond);
+
+// Connectivity query between the endpoints of the first and last edge; for the grid and
+// the path these are opposite corners, so the whole graph is traversed.
+static void BM_Graph_Traversal(benchmark::State& state) {
+	const vector<Edge<uint32_t> >& edges = synthetic_edges(state.range(0), state.range(1));
+	Graph<uint32_t> graph = build_graph(edges);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(graph.has_connection(edges.front().getFirst(), edges.back().getSecond()));
+	label_graph(state, edges);
+}
+BENCHMARK(BM_Graph_Traversal) GRAPH_SHAPES->Unit(benchmark::kMicrosecond);
+
+// Full BFS of the first endpoint's component, matching the full DFS that has_connection
+// runs before it looks at the target.
+static void BM_Baseline_Traversal(benchmark::State& state) {
+	const vector<Edge<uint32_t> >& edges = synthetic_edges(state.range(0), state.range(1));
+	Csr_Graph<uint32_t> csr = build_graph(edges).to_csr();
+	uint32_t first = csr.index_of(edges.front().getFirst()), last = csr.index_of(edges.back().getSecond());
+	vector<char> visited(csr.node_count());
+	vector<uint32_t> frontier;
+	for (auto _ : state) {
+		fill(visited.begin(), visited.end(), false);
+		frontier.assign(1, first);
+		visited[frontier[0]] = true;
+		for (size_t head = 0; head < frontier.size(); head++)
+			for (uint64_t edge = csr.offsets()[frontier[head]]; edge < csr.offsets()[frontier[head] + 1]; edge++)
+				if (!visited[csr.targets()[edge]]) {
+					visited[csr.targets()[edge]] = true;
+					frontier.push_back(csr.targets()[edge]);
+				}
+		benchmark::DoNotOptimize(visited[last]);
+	}
+	label_graph(state, edges);
+}
+BENCHMARK(BM_Baseline_Traversal) GRAPH_SHAPES->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
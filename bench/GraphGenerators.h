@@ -0,0 +1,56 @@
+#pragma once
+
+// Synthetic edge lists shared by the graph benchmarks.
+
+#include "../Graph.h"
+#include <random>
+
+// Recursive matrix (RMAT) graph with the Graph500 quadrant probabilities. Labels are
+// shuffled so that the key order of the resulting Graph carries no locality.
+inline vector<Edge<uint32_t> > rmat_edges(int scale, int edge_factor, uint32_t seed) {
+	mt19937_64 random(seed);
+	uniform_real_distribution<double> coin(0.0, 1.0);
+	uint32_t nodes = 1u << scale;
+
+	vector<uint32_t> labels(nodes);
+	iota(labels.begin(), labels.end(), 0);
+	shuffle(labels.begin(), labels.end(), random);
+
+	vector<Edge<uint32_t> > edges;
+	edges.reserve((size_t)nodes * edge_factor);
+	for (size_t i = 0; i < (size_t)nodes * edge_factor; i++) {
+		uint32_t first = 0, second = 0;
+		for (int bit = 0; bit < scale; bit++) {
+			double draw = coin(random);
+			if (draw >= 0.57 + 0.19)
+				first |= 1u << bit;
+			if ((draw >= 0.57 and draw < 0.57 + 0.19) or draw >= 0.57 + 0.19 + 0.19)
+				second |= 1u << bit;
+		}
+		edges.emplace_back(labels[first], labels[second]);
+	}
+	return edges;
+}
+
+// side x side grid, every vertex joined to its right and lower neighbour.
+inline vector<Edge<uint32_t> > grid_edges(uint32_t side) {
+	vector<Edge<uint32_t> > edges;
+	edges.reserve(2 * (size_t)side * side);
+	for (uint32_t row = 0; row < side; row++)
+		for (uint32_t column = 0; column < side; column++) {
+			uint32_t node = row * side + column;
+			if (column + 1 < side)
+				edges.emplace_back(node, node + 1);
+			if (row + 1 < side)
+				edges.emplace_back(node, node + side);
+		}
+	return edges;
+}
+
+inline vector<Edge<uint32_t> > path_edges(uint32_t length) {
+	vector<Edge<uint32_t> > edges;
+	edges.reserve(length);
+	for (uint32_t node = 0; node + 1 < length; node++)
+		edges.emplace_back(node, node + 1);
+	return edges;
+}
@@ -0,0 +1,95 @@
+// Compares BFS and PageRank running time on a Csr_Graph under each vertex ordering of
+// GraphOrder.h. The input is an RMAT graph whose labels are shuffled, so the original
+// order carries no locality at all.
+//
+//   GraphOrderBench [scale = 16] [edge factor = 8]
+
+#include "../Graph.h"
+#include "../GraphOrder.h"
+#include "GraphGenerators.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+using Clock = chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+	return chrono::duration<double>(Clock::now() - start).count();
+}
+
+static size_t bfs(const Csr_Graph<uint32_t>& csr, uint32_t source) {
+	vector<char> visited(csr.node_count(), false);
+	vector<uint32_t> frontier(1, source);
+	visited[source] = true;
+	for (size_t head = 0; head < frontier.size(); head++)
+		for (uint64_t edge = csr.offsets()[frontier[head]]; edge < csr.offsets()[frontier[head] + 1]; edge++)
+			if (!visited[csr.targets()[edge]]) {
+				visited[csr.targets()[edge]] = true;
+				frontier.push_back(csr.targets()[edge]);
+			}
+	return frontier.size();
+}
+
+static double pagerank(const Csr_Graph<uint32_t>& csr, int iterations) {
+	size_t nodes = csr.node_count();
+	vector<double> rank(nodes, 1.0 / nodes), contribution(nodes);
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		for (size_t node = 0; node < nodes; node++)
+			contribution[node] = csr.degree((uint32_t)node) == 0 ? 0 : rank[node] / csr.degree((uint32_t)node);
+		for (size_t node = 0; node < nodes; node++) {
+			double sum = 0;
+			for (uint64_t edge = csr.offsets()[node]; edge < csr.offsets()[node + 1]; edge++)
+				sum += contribution[csr.targets()[edge]];
+			rank[node] = 0.15 / nodes + 0.85 * sum;
+		}
+	}
+	return rank[0];
+}
+
+int main(int argc, char** argv) {
+	int scale = argc > 1 ? atoi(argv[1]) : 16;
+	int edge_factor = argc > 2 ? atoi(argv[2]) : 8;
+
+	Graph<uint32_t> graph;
+	graph.build_from_edge_list(rmat_edges(scale, edge_factor, 42));
+	Csr_Graph<uint32_t> original = graph.to_csr();
+	printf("rmat scale %d: %zu nodes, %zu adjacency entries\n\n", scale, original.node_count(), original.edge_count());
+
+	vector<pair<const char*, function<vector<uint32_t>(const Csr_Graph<uint32_t>&)> > > orderings = {
+		{ "original", [](const Csr_Graph<uint32_t>& csr) { vector<uint32_t> rank(csr.node_count()); iota(rank.begin(), rank.end(), 0); return rank; } },
+		{ "degree", [](const Csr_Graph<uint32_t>& csr) { return degree_order(csr, false); } },
+		{ "hub sort", [](const Csr_Graph<uint32_t>& csr) { return degree_order(csr, true); } },
+		{ "rcm", [](const Csr_Graph<uint32_t>& csr) { return reverse_cuthill_mckee(csr); } },
+		{ "gorder", [](const Csr_Graph<uint32_t>& csr) { return gorder(csr); } },
+	};
+
+	const int SOURCES = 8, ITERATIONS = 20;
+	double base_bfs = 0, base_pagerank = 0;
+	printf("%-10s %12s %12s %9s %12s %9s\n", "ordering", "reorder (s)", "bfs (s)", "speedup", "pagerank (s)", "speedup");
+	for (auto& [name, ordering] : orderings) {
+		Clock::time_point start = Clock::now();
+		vector<uint32_t> rank = ordering(original);
+		Csr_Graph<uint32_t> csr = relabel(original, rank);
+		double reorder_time = seconds_since(start);
+
+		start = Clock::now();
+		size_t reached = 0;
+		for (int source = 0; source < SOURCES; source++)
+			reached += bfs(csr, rank[source * (original.node_count() / SOURCES)]);
+		double bfs_time = seconds_since(start);
+
+		start = Clock::now();
+		volatile double sink = pagerank(csr, ITERATIONS);
+		(void)sink;
+		double pagerank_time = seconds_since(start);
+
+		if (base_bfs == 0) {
+			base_bfs = bfs_time;
+			base_pagerank = pagerank_time;
+		}
+		printf("%-10s %12.4f %12.4f %8.2fx %12.4f %8.2fx   (reached %zu)\n", name, reorder_time, bfs_time,
+			base_bfs / bfs_time, pagerank_time, base_pagerank / pagerank_time, reached);
+	}
+	return 0;
+}
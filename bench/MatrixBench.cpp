@@ -0,0 +1,168 @@
+// Matrix multiply, transpose, power and stream parsing against flat row-major loops.
+
+#include "Benchmark.h"
+#include "../Matrix.h"
+#include <charconv>
+#include <random>
+#include <sstream>
+#include <string>
+
+using std::vector;
+
+static Matrix<double> random_matrix(size_t size, unsigned seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<double> value(0.0, 1.0 / size);
+	Matrix<double> matrix(size, size);
+	for (size_t row = 0; row < size; row++)
+		for (size_t column = 0; column < size; column++)
+			matrix[row][column] = value(random);
+	return matrix;
+}
+
+static vector<double> flatten(const Matrix<double>& matrix) {
+	vector<double> flat;
+	for (size_t row = 0; row < matrix.size(); row++)
+		flat.insert(flat.end(), matrix[row].begin(), matrix[row].end());
+	return flat;
+}
+
+// Row-major i-k-j product, the baseline every multiply is compared against.
+template<typename T>
+static void naive_multiply(const vector<T>& first, const vector<T>& second, vector<T>& result, size_t size) {
+	std::fill(result.begin(), result.end(), (T)0);
+	for (size_t row = 0; row < size; row++)
+		for (size_t middle = 0; middle < size; middle++) {
+			T scale = first[row * size + middle];
+			for (size_t column = 0; column < size; column++)
+				result[row * size + column] += scale * second[middle * size + column];
+		}
+}
+
+static void BM_Matrix_Multiply(benchmark::State& state) {
+	size_t size = (size_t)state.range(0);
+	Matrix<double> first = random_matrix(size, 1), second = random_matrix(size, 2);
+	for (auto _ : state) {
+		Matrix<double> product = first * second;
+		benchmark::DoNotOptimize(product[0][0]);
+	}
+	state.counters["flops"] = 2.0 * size * size * size;
+}
+BENCHMARK(BM_Matrix_Multiply)->Arg(16)->Arg(64)->Arg(128)->Arg(256);
+
+static void BM_Naive_Multiply(benchmark::State& state) {
+	size_t size = (size_t)state.range(0);
+	vector<double> first = flatten(random_matrix(size, 1)), second = flatten(random_matrix(size, 2)), product(size * size);
+	for (auto _ : state) {
+		naive_multiply(first, second, product, size);
+		benchmark::DoNotOptimize(product[0]);
+	}
+	state.counters["flops"] = 2.0 * size * size * size;
+}
+BENCHMARK(BM_Naive_Multiply)->Arg(16)->Arg(64)->Arg(128)->Arg(256);
+
+static void BM_Matrix_Transpose(benchmark::State& state) {
+	Matrix<double> matrix = random_matrix((size_t)state.range(0), 1);
+	for (auto _ : state) {
+		Matrix<double> transposed = matrix.transpose();
+		benchmark::DoNotOptimize(transposed[0][0]);
+	}
+}
+BENCHMARK(BM_Matrix_Transpose)->Arg(64)->Arg(256)->Arg(1024);
+
+static void BM_Naive_Transpose(benchmark::State& state) {
+	size_t size = (size_t)state.range(0);
+	vector<double> matrix = flatten(random_matrix(size, 1)), transposed(size * size);
+	for (auto _ : state) {
+		for (size_t row = 0; row < size; row++)
+			for (size_t column = 0; column < size; column++)
+				transposed[column * size + row] = matrix[row * size + column];
+		benchmark::DoNotOptimize(transposed[0]);
+	}
+}
+BENCHMARK(BM_Naive_Transpose)->Arg(64)->Arg(256)->Arg(1024);
+
+// Unsigned entries so that large powers wrap instead of overflowing.
+static void BM_Matrix_Power(benchmark::State& state) {
+	size_t size = (size_t)state.range(0);
+	Matrix<unsigned long long> matrix(size, size, 1ULL);
+	for (auto _ : state) {
+		Matrix<unsigned long long> power = matrix ^ state.range(1);
+		benchmark::DoNotOptimize(power[0][0]);
+	}
+}
+BENCHMARK(BM_Matrix_Power)->Args({ 2, 90 })->Args({ 8, 1000 })->Args({ 32, 1000 })->Args({ 64, 64 });
+
+// Same kernel on the inline, statically sized Matrix<T, R, C>.
+template<size_t N>
+static void BM_Fixed_Matrix_Power(benchmark::State& state) {
+	Matrix<unsigned long long, N, N> matrix(1ULL);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(matrix);
+		Matrix<unsigned long long, N, N> power = matrix ^ state.range(0);
+		benchmark::DoNotOptimize(power[0][0]);
+	}
+}
+BENCHMARK(BM_Fixed_Matrix_Power<2>)->Arg(90);
+BENCHMARK(BM_Fixed_Matrix_Power<8>)->Arg(1000);
+
+static void BM_Naive_Power(benchmark::State& state) {
+	size_t size = (size_t)state.range(0);
+	vector<unsigned long long> base(size * size, 1ULL), result(size * size), helper(size * size), scratch(size * size);
+	for (auto _ : state) {
+		std::fill(result.begin(), result.end(), 0ULL);
+		for (size_t i = 0; i < size; i++)
+			result[i * size + i] = 1;
+		helper = base;
+		for (int64_t power = state.range(1); power > 0; power >>= 1) {
+			if (power & 1) {
+				naive_multiply(result, helper, scratch, size);
+				result.swap(scratch);
+			}
+			naive_multiply(helper, helper, scratch, size);
+			helper.swap(scratch);
+		}
+		benchmark::DoNotOptimize(result[0]);
+	}
+}
+BENCHMARK(BM_Naive_Power)->Args({ 2, 90 })->Args({ 8, 1000 })->Args({ 32, 1000 })->Args({ 64, 64 });
+
+static std::string matrix_text(size_t size) {
+	std::mt19937 random(3);
+	std::string text;
+	for (size_t i = 0; i < size * size; i++)
+		text += std::to_string(random() % 100000) + (i % size == size - 1 ? '\n' : ' ');
+	return text;
+}
+
+static void BM_Matrix_Parse(benchmark::State& state) {
+	size_t size = (size_t)state.range(0);
+	std::string text = matrix_text(size);
+	Matrix<int> matrix(size, size);
+	for (auto _ : state) {
+		std::istringstream input(text);
+		input >> matrix;
+		benchmark::DoNotOptimize(matrix[0][0]);
+	}
+	state.SetBytesProcessed(state.iterations() * (int64_t)text.size());
+}
+BENCHMARK(BM_Matrix_Parse)->Arg(64)->Arg(256)->Arg(1024);
+
+static void BM_Naive_Parse(benchmark::State& state) {
+	size_t size = (size_t)state.range(0);
+	std::string text = matrix_text(size);
+	vector<int> matrix(size * size);
+	for (auto _ : state) {
+		const char* position = text.data();
+		const char* end = text.data() + text.size();
+		for (size_t i = 0; i < size * size; i++) {
+			while (*position == ' ' || *position == '\n')
+				position++;
+			position = std::from_chars(position, end, matrix[i]).ptr;
+		}
+		benchmark::DoNotOptimize(matrix[0]);
+	}
+	state.SetBytesProcessed(state.iterations() * (int64_t)text.size());
+}
+BENCHMARK(BM_Naive_Parse)->Arg(64)->Arg(256)->Arg(1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+// Vector against std::vector: push_back, pop_back and copy construction of ints.
+
+#include "Benchmark.h"
+#include "../Vector.h"
+#include <vector>
+
+static void BM_Vector_PushBack(benchmark::State& state) {
+	for (auto _ : state) {
+		Vector<int> values;
+		for (int64_t i = 0; i < state.range(0); i++)
+			values.push_back((int)i);
+		benchmark::DoNotOptimize(values[0]);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Vector_PushBack)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_StdVector_PushBack(benchmark::State& state) {
+	for (auto _ : state) {
+		std::vector<int> values;
+		for (int64_t i = 0; i < state.range(0); i++)
+			values.push_back((int)i);
+		benchmark::DoNotOptimize(values[0]);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdVector_PushBack)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_Vector_PopBack(benchmark::State& state) {
+	for (auto _ : state) {
+		state.PauseTiming();
+		Vector<int> values;
+		for (int64_t i = 0; i < state.range(0); i++)
+			values.push_back((int)i);
+		state.ResumeTiming();
+		for (int64_t i = 0; i < state.range(0); i++)
+			values.pop_back();
+		benchmark::DoNotOptimize(values.size());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Vector_PopBack)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_StdVector_PopBack(benchmark::State& state) {
+	for (auto _ : state) {
+		state.PauseTiming();
+		std::vector<int> values;
+		for (int64_t i = 0; i < state.range(0); i++)
+			values.push_back((int)i);
+		state.ResumeTiming();
+		for (int64_t i = 0; i < state.range(0); i++)
+			values.pop_back();
+		benchmark::DoNotOptimize(values.size());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdVector_PopBack)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_Vector_Copy(benchmark::State& state) {
+	Vector<int> values;
+	for (int64_t i = 0; i < state.range(0); i++)
+		values.push_back((int)i);
+	for (auto _ : state) {
+		Vector<int> copy(values);
+		benchmark::DoNotOptimize(copy[0]);
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) * (int64_t)sizeof(int));
+}
+BENCHMARK(BM_Vector_Copy)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_StdVector_Copy(benchmark::State& state) {
+	std::vector<int> values;
+	for (int64_t i = 0; i < state.range(0); i++)
+		values.push_back((int)i);
+	for (auto _ : state) {
+		std::vector<int> copy(values);
+		benchmark::DoNotOptimize(copy[0]);
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) * (int64_t)sizeof(int));
+}
+BENCHMARK(BM_StdVector_Copy)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+BENCHMARK_MAIN();
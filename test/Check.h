@@ -0,0 +1,33 @@
+#pragma once
+
+// Minimal assertions for the test executables. Unlike assert() they stay active in
+// Release builds; a failed check is reported and makes the test exit with status 1.
+
+#include <cstdio>
+#include <exception>
+
+inline int& check_failures()
+{
+	static int failures = 0;
+	return failures;
+}
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			check_failures()++; \
+		} \
+	} while (0)
+
+#define CHECK_THROWS(expression) \
+	do { \
+		bool _thrown = false; \
+		try { (void)(expression); } catch (const std::exception&) { _thrown = true; } \
+		if (!_thrown) { \
+			std::fprintf(stderr, "%s:%d: expected an exception from: %s\n", __FILE__, __LINE__, #expression); \
+			check_failures()++; \
+		} \
+	} while (0)
+
+#define CHECK_RESULT() (check_failures() == 0 ? 0 : 1)
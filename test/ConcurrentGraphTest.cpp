@@ -0,0 +1,138 @@
+// Readers scanning Concurrent_Graph snapshots while a writer publishes batches. Every
+// snapshot must be exactly the state after some whole batch, and versions seen by one
+// reader never go backwards. Also covers copy-on-write sharing of Graph adjacency.
+
+#include "../ConcurrentGraph.h"
+#include "Check.h"
+
+const uint32_t NODES = 512;
+const uint32_t ROUNDS = 400;
+const size_t READERS = 4;
+
+static void test_shared_adjacency() {
+	Graph<int> original;
+	for (int node = 0; node < 4; node++)
+		original.insert_node(node);
+	original.insert_edge(Edge<int>(0, 1, 2.0));
+	original.insert_edge(Edge<int>(1, 2, 3.0));
+
+	Graph<int> copy = original;
+	copy.insert_edge(Edge<int>(2, 3));
+	copy.change_weight(Edge<int>(0, 1), 5.0);
+	copy.remove_edge(Edge<int>(1, 2));
+
+	CHECK(!original.has_edge(2, 3) && original.has_edge(1, 2));
+	CHECK(original.to_csr().weights()[0] == 2.0);
+	CHECK(copy.has_edge(2, 3) && !copy.has_edge(1, 2));
+	CHECK(copy.to_csr().weights()[0] == 5.0);
+
+	copy.remove_node(1);
+	CHECK(original.has_edge(0, 1) && original.total_components() == 2);
+	CHECK(copy.total_components() == 2);
+}
+
+static void test_batches() {
+	Graph<uint32_t> initial;
+	for (uint32_t node = 0; node < 4; node++)
+		initial.insert_node(node);
+	Concurrent_Graph<uint32_t> graph(initial);
+
+	CHECK(graph.publish() == 0);
+	graph.insert_edge(Edge<uint32_t>(0, 1));
+	CHECK(graph.publish() == 1);
+	CHECK(graph.publish() == 1);
+
+	graph.insert_edge(Edge<uint32_t>(2, 3));
+	graph.insert_edge(Edge<uint32_t>(0, 1));
+	CHECK_THROWS(graph.publish());
+	CHECK(graph.version() == 1);
+	CHECK(!graph.read()->has_edge(2, 3));
+	CHECK(graph.publish() == 1);
+
+	CHECK(graph.update([](Graph<uint32_t>& next) { next.remove_edge(Edge<uint32_t>(0, 1)); }) == 2);
+	CHECK(!graph.read()->has_edge(0, 1));
+}
+
+// Round r adds the path edge (r - 1, r) with weight r and raises the weight of edge
+// (0, 1) to r, so version v has v edges, NODES - v components and weight(0, 1) = v.
+static void test_readers_and_writer() {
+	Graph<uint32_t> initial;
+	for (uint32_t node = 0; node < NODES; node++)
+		initial.insert_node(node);
+	Concurrent_Graph<uint32_t> graph(initial);
+
+	atomic<bool> done(false);
+	atomic<int> failures(0);
+	vector<thread> readers;
+	for (size_t reader = 0; reader < READERS; reader++)
+		readers.emplace_back([&] {
+			uint64_t last = 0;
+			while (!done.load()) {
+				// Extra pinned snapshots push the readers past READER_SLOTS into overflow slots.
+				vector<Concurrent_Graph<uint32_t>::Reader> pinned;
+				for (size_t extra = 0; extra < 40; extra++)
+					pinned.push_back(graph.read());
+				Concurrent_Graph<uint32_t>::Reader snapshot = graph.read();
+				uint64_t version = snapshot.version();
+				Csr_Graph<uint32_t> csr = snapshot->to_csr();
+				bool valid = version >= last and csr.edge_count() == 2 * version
+					and (version == 0 or (snapshot->has_edge(version - 1, (uint32_t)version) and csr.weights()[0] == (double)version))
+					and !snapshot->has_edge((uint32_t)version, (uint32_t)version + 1);
+				if (version % 16 == 0)
+					valid = valid and snapshot->total_components() == (int)(NODES - version);
+				if (!valid)
+					failures++;
+				last = version;
+			}
+		});
+
+	for (uint32_t round = 1; round <= ROUNDS; round++) {
+		graph.insert_edge(Edge<uint32_t>(round - 1, round, round));
+		if (round > 1)
+			graph.change_weight(Edge<uint32_t>(0, 1), round);
+		graph.publish();
+	}
+	done.store(true);
+	for (thread& reader : readers)
+		reader.join();
+
+	CHECK(failures.load() == 0);
+	CHECK(graph.version() == ROUNDS);
+	CHECK(graph.read()->total_components() == (int)(NODES - ROUNDS));
+}
+
+// More live readers than lock free slots: the extra ones use overflow slots, keep their
+// snapshots alive across publishes and free them once released.
+static void test_many_readers() {
+	Graph<uint32_t> initial;
+	for (uint32_t node = 0; node < 4; node++)
+		initial.insert_node(node);
+	Concurrent_Graph<uint32_t> graph(initial);
+
+	vector<Concurrent_Graph<uint32_t>::Reader> held;
+	for (size_t reader = 0; reader < 300; reader++)
+		held.push_back(graph.read());
+	graph.insert_edge(Edge<uint32_t>(0, 1));
+	CHECK(graph.publish() == 1);
+	for (size_t reader = 0; reader < 300; reader++) {
+		held.push_back(graph.read());
+		CHECK(held.back().version() == 1 && held.back()->has_edge(0, 1));
+	}
+	bool unchanged = true;
+	for (size_t reader = 0; reader < 300; reader++)
+		unchanged = unchanged and held[reader].version() == 0 and !held[reader]->has_edge(0, 1);
+	CHECK(unchanged);
+
+	held.clear();
+	graph.insert_edge(Edge<uint32_t>(2, 3));
+	CHECK(graph.publish() == 2);
+	CHECK(graph.read()->has_edge(2, 3));
+}
+
+int main() {
+	test_shared_adjacency();
+	test_batches();
+	test_readers_and_writer();
+	test_many_readers();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,70 @@
+// Matrix<T, R, C>: arithmetic is checked at compile time, conversions to and from
+// Matrix<T> and the initializer list size checks at run time.
+
+#include "../Matrix.h"
+#include "Check.h"
+
+typedef Matrix<unsigned long long, 2, 2> Step;
+
+static constexpr unsigned long long fibonacci(long long n) {
+	return (Step{ { 1, 1 }, { 1, 0 } } ^ n)[0][1];
+}
+
+static_assert(fibonacci(0) == 0 && fibonacci(1) == 1 && fibonacci(10) == 55, "small Fibonacci numbers");
+static_assert(fibonacci(90) == 2880067194370816120ULL, "power by squaring");
+static_assert((Step::getIdentity() ^ 5) == Step::getIdentity(), "identity power");
+
+constexpr Matrix<int, 2, 3> WIDE{ { 1, 2, 3 }, { 4, 5, 6 } };
+constexpr Matrix<int, 3, 2> TALL = WIDE.transpose();
+static_assert(TALL.size() == 3 && TALL.rsize() == 2, "transpose swaps the extents");
+static_assert(TALL[0][1] == 4 && TALL[2][0] == 3 && TALL.transpose() == WIDE, "transpose moves elements");
+
+constexpr Matrix<int, 2, 2> GRAM = WIDE * TALL;
+static_assert(GRAM == Matrix<int, 2, 2>{ { 14, 32 }, { 32, 77 } }, "2x3 times 3x2");
+constexpr Matrix<int, 3, 3> OUTER = TALL * WIDE;
+static_assert(OUTER[0][0] == 17 && OUTER[1][2] == 36 && OUTER[2][1] == 36, "3x2 times 2x3");
+
+static void test_conversions() {
+	Matrix<int> dynamic = WIDE;
+	CHECK(dynamic.size() == 2 && dynamic.rsize() == 3);
+	CHECK(dynamic[1][2] == 6);
+	CHECK((dynamic * (Matrix<int>)TALL) == (Matrix<int>)GRAM);
+
+	dynamic[0][0] = 10;
+	Matrix<int, 2, 3> back(dynamic);
+	CHECK(back[0][0] == 10 && back[1][2] == 6);
+	back[0][0] = 1;
+	CHECK(back == WIDE);
+
+	CHECK_THROWS((Matrix<int, 3, 2>(dynamic)));
+	CHECK_THROWS((Matrix<int, 2, 2>(dynamic)));
+	CHECK_THROWS((Matrix<int, 2, 3>(Matrix<int>())));
+}
+
+static void test_initializer_sizes() {
+	CHECK_THROWS((Matrix<int, 2, 2>{ { 1, 2 } }));
+	CHECK_THROWS((Matrix<int, 2, 2>{ { 1, 2 }, { 3 } }));
+	CHECK_THROWS((Matrix<int, 2, 2>{ { 1, 2 }, { 3, 4, 5 } }));
+	CHECK_THROWS((Matrix<int, 2, 2>{ { 1, 2 }, { 3, 4 }, { 5, 6 } }));
+}
+
+static void test_runtime_arithmetic() {
+	Step step{ { 1, 1 }, { 1, 0 } };
+	step ^= 20;
+	CHECK(step[0][1] == 6765);
+
+	Matrix<int, 2, 2> square{ { 1, 2 }, { 3, 4 } };
+	square += Matrix<int, 2, 2>(1);
+	square -= Matrix<int, 2, 2>::getIdentity();
+	square.selfTranspose();
+	CHECK((square == Matrix<int, 2, 2>{ { 1, 4 }, { 3, 4 } }));
+	square *= Matrix<int, 2, 2>::getIdentity();
+	CHECK(square[0][1] == 4);
+}
+
+int main() {
+	test_conversions();
+	test_initializer_sizes();
+	test_runtime_arithmetic();
+	return CHECK_RESULT();
+}
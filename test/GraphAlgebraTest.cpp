@@ -0,0 +1,119 @@
+// PageRank, triangle counting and sparse products of GraphAlgebra.h, checked against
+// serial reference loops on graphs large enough to run multithreaded on multicore hosts.
+
+#include "../GraphAlgebra.h"
+#include "Check.h"
+#include <cmath>
+
+static Graph<uint32_t> ring_with_chords(uint32_t nodes) {
+	vector<Edge<uint32_t> > edges;
+	for (uint32_t node = 0; node < nodes; node++) {
+		edges.emplace_back(node, (node + 1) % nodes, 1.0 + node % 3);
+		if (node % 7 == 0)
+			edges.emplace_back(node, (node + 2) % nodes, 2.0);
+	}
+	Graph<uint32_t> graph;
+	graph.build_from_edge_list(edges);
+	return graph;
+}
+
+static void test_sparse_product() {
+	Csr_Graph<uint32_t> csr = ring_with_chords(50000).to_csr();
+	Sparse_Matrix<double> matrix = to_sparse_matrix<double>(csr);
+	vector<double> input(csr.node_count());
+	for (size_t node = 0; node < input.size(); node++)
+		input[node] = (double)(node % 11);
+
+	vector<double> output = matrix * input;
+	bool equal = output.size() == csr.node_count();
+	for (size_t node = 0; equal and node < csr.node_count(); node++) {
+		double sum = 0;
+		for (uint64_t edge = csr.offsets()[node]; edge < csr.offsets()[node + 1]; edge++)
+			sum += csr.weights()[edge] * input[csr.targets()[edge]];
+		equal = output[node] == sum;
+	}
+	CHECK(equal);
+	CHECK((matrix * vector<double>(3)).empty());
+}
+
+// Textbook power iteration: every vertex pushes rank / degree to its neighbours and the
+// rank of isolated vertices is spread like the teleport mass.
+static vector<double> reference_pagerank(const Csr_Graph<uint32_t>& csr, const vector<double>& teleport, size_t iterations) {
+	const double DAMPING = 0.85;
+	vector<double> rank(teleport);
+	for (size_t iteration = 0; iteration < iterations; iteration++) {
+		vector<double> next(csr.node_count(), 0.0);
+		double lost = 0;
+		for (uint32_t node = 0; node < csr.node_count(); node++) {
+			uint64_t degree = csr.degree(node);
+			if (degree == 0)
+				lost += rank[node];
+			for (uint64_t edge = csr.offsets()[node]; edge < csr.offsets()[node + 1]; edge++)
+				next[csr.targets()[edge]] += DAMPING * rank[node] / degree;
+		}
+		for (uint32_t node = 0; node < csr.node_count(); node++)
+			next[node] += (1.0 - DAMPING + DAMPING * lost) * teleport[node];
+		rank.swap(next);
+	}
+	return rank;
+}
+
+static double largest_difference(const vector<double>& first, const vector<double>& second) {
+	if (first.size() != second.size())
+		return INFINITY;
+	double difference = 0;
+	for (size_t i = 0; i < first.size(); i++)
+		difference = max(difference, fabs(first[i] - second[i]));
+	return difference;
+}
+
+static void test_pagerank() {
+	// Isolated vertices exercise the redistribution of dangling rank.
+	Graph<uint32_t> graph = ring_with_chords(50000);
+	for (uint32_t node = 50000; node < 50100; node++)
+		graph.insert_node(node);
+	Csr_Graph<uint32_t> csr = graph.to_csr();
+
+	vector<double> rank = pagerank(csr, 0.85, 1e-14, 300);
+	vector<double> uniform(csr.node_count(), 1.0 / csr.node_count());
+	CHECK(largest_difference(rank, reference_pagerank(csr, uniform, 300)) < 1e-12);
+	CHECK(fabs(accumulate(rank.begin(), rank.end(), 0.0) - 1.0) < 1e-9);
+
+	vector<double> personalized = personalized_pagerank(csr, { 0, 50050 }, 0.85, 1e-14, 300);
+	vector<double> teleport(csr.node_count(), 0.0);
+	teleport[0] = teleport[50050] = 0.5;
+	CHECK(largest_difference(personalized, reference_pagerank(csr, teleport, 300)) < 1e-12);
+	CHECK(personalized[0] > personalized[25000]);
+	CHECK_THROWS(personalized_pagerank(csr, { (uint32_t)csr.node_count() }));
+
+	// On a regular graph the uniform vector is the fixed point.
+	vector<Edge<uint32_t> > ring;
+	for (uint32_t node = 0; node < 40000; node++)
+		ring.emplace_back(node, (node + 1) % 40000);
+	Graph<uint32_t> regular;
+	regular.build_from_edge_list(ring);
+	vector<double> flat = pagerank(regular.to_csr());
+	CHECK(largest_difference(flat, vector<double>(40000, 1.0 / 40000)) < 1e-15);
+}
+
+static void test_triangles() {
+	// Each chord (n, n + 2) closes exactly one triangle with the ring edges around it.
+	Csr_Graph<uint32_t> csr = ring_with_chords(70000).to_csr();
+	CHECK(count_triangles(csr) == 10000);
+
+	Graph<int> complete;
+	for (int node = 0; node < 6; node++)
+		complete.insert_node(node);
+	for (int first = 0; first < 6; first++)
+		for (int second = first + 1; second < 6; second++)
+			complete.insert_edge(Edge<int>(first, second));
+	CHECK(count_triangles(complete.to_csr()) == 20);
+	CHECK(to_adjacency_matrix<int>(complete)[2][4] == 1);
+}
+
+int main() {
+	test_sparse_product();
+	test_pagerank();
+	test_triangles();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,114 @@
+// Edge list parsing and the binary CSR round trip of GraphIO.h, including rejection of
+// malformed and corrupt files.
+
+#include "../GraphIO.h"
+#include "Check.h"
+#include <cstdio>
+
+static void write_file(const string& path, const string& text) {
+	ofstream output(path, ios::binary | ios::trunc);
+	output << text;
+}
+
+static string read_file(const string& path) {
+	ifstream input(path, ios::binary);
+	return string(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+}
+
+static void test_read_edge_list() {
+	write_file("edges.txt", "# comment\n1 2\n\n% comment\n2 3 0.5\r\n  3\t1  2.25\n4 5");
+	vector<Edge<uint32_t> > edges = read_edge_list<uint32_t>("edges.txt");
+	CHECK(edges.size() == 4);
+	CHECK(edges[0].getFirst() == 1 && edges[0].getSecond() == 2 && edges[0].getWeight() == 1.0);
+	CHECK(edges[1].getFirst() == 2 && edges[1].getSecond() == 3 && edges[1].getWeight() == 0.5);
+	CHECK(edges[2].getFirst() == 3 && edges[2].getSecond() == 1 && edges[2].getWeight() == 2.25);
+	CHECK(edges[3].getFirst() == 4 && edges[3].getSecond() == 5);
+
+	// Fields run together: "1 2.5" is not (1, 2, 0.5) and "3-4" is not (3, -4).
+	for (const char* text : { "1 2\n3 x\n", "1 2.5\n", "3-4\n", "1 2 3 4\n", "1\n" }) {
+		write_file("malformed.txt", text);
+		CHECK_THROWS(read_edge_list<int32_t>("malformed.txt"));
+	}
+	CHECK_THROWS(read_edge_list<uint32_t>("missing.txt"));
+}
+
+static void test_binary_round_trip() {
+	string text;
+	for (uint32_t node = 0; node < 2000; node++)
+		text += to_string(node) + " " + to_string((node * 7 + 3) % 2000) + " " + to_string(node % 5) + "\n";
+	write_file("graph.txt", text);
+
+	Graph<uint32_t> graph;
+	load_edge_list(graph, "graph.txt");
+	Csr_Graph<uint32_t> csr = graph.to_csr();
+	save_binary(csr, "graph.bin");
+	Csr_Graph<uint32_t> opened = open_binary<uint32_t>("graph.bin");
+
+	CHECK(opened.node_count() == csr.node_count());
+	CHECK(opened.edge_count() == csr.edge_count());
+	CHECK(equal(csr.nodes(), csr.nodes() + csr.node_count(), opened.nodes()));
+	CHECK(equal(csr.offsets(), csr.offsets() + csr.node_count() + 1, opened.offsets()));
+	CHECK(equal(csr.targets(), csr.targets() + csr.edge_count(), opened.targets()));
+	CHECK(equal(csr.weights(), csr.weights() + csr.edge_count(), opened.weights()));
+	CHECK_THROWS(open_binary<uint64_t>("graph.bin"));
+
+	save_binary(Csr_Graph<uint32_t>(), "empty.bin");
+	CHECK(open_binary<uint32_t>("empty.bin").node_count() == 0);
+}
+
+static void test_corrupt_binary() {
+	string image = read_file("graph.bin");
+	size_t offsets_begin = sizeof(Binary_Graph_Header);
+	Binary_Graph_Header header;
+	memcpy(&header, image.data(), sizeof(header));
+
+	string corrupt = image;
+	corrupt[0] = 'X';
+	write_file("corrupt.bin", corrupt);
+	CHECK_THROWS(open_binary<uint32_t>("corrupt.bin"));
+
+	write_file("corrupt.bin", image.substr(0, image.size() - 1));
+	CHECK_THROWS(open_binary<uint32_t>("corrupt.bin"));
+
+	corrupt = image;
+	uint64_t offset = 5;
+	memcpy(&corrupt[offsets_begin], &offset, sizeof(offset));
+	write_file("corrupt.bin", corrupt);
+	CHECK_THROWS(open_binary<uint32_t>("corrupt.bin"));
+
+	corrupt = image;
+	offset = header.edge_count + 1;
+	memcpy(&corrupt[offsets_begin + header.node_count * sizeof(uint64_t)], &offset, sizeof(offset));
+	write_file("corrupt.bin", corrupt);
+	CHECK_THROWS(open_binary<uint32_t>("corrupt.bin"));
+
+	// An interior offset that decreases, and one beyond edge_count.
+	size_t middle = offsets_begin + header.node_count / 2 * sizeof(uint64_t);
+	for (uint64_t bad_offset : { (uint64_t)0, header.edge_count + 1 }) {
+		corrupt = image;
+		memcpy(&corrupt[middle], &bad_offset, sizeof(bad_offset));
+		write_file("corrupt.bin", corrupt);
+		CHECK_THROWS(open_binary<uint32_t>("corrupt.bin"));
+	}
+
+	// A target naming no vertex.
+	corrupt = image;
+	uint32_t target = 4000000000u;
+	size_t targets_begin = offsets_begin + (header.node_count + 1) * sizeof(uint64_t) + header.edge_count * sizeof(double);
+	memcpy(&corrupt[targets_begin + header.edge_count / 2 * sizeof(uint32_t)], &target, sizeof(target));
+	write_file("corrupt.bin", corrupt);
+	CHECK_THROWS(open_binary<uint32_t>("corrupt.bin"));
+
+	corrupt = image;
+	header.node_count = (uint64_t)UINT32_MAX + 1;
+	memcpy(&corrupt[0], &header, sizeof(header));
+	write_file("corrupt.bin", corrupt);
+	CHECK_THROWS(open_binary<uint32_t>("corrupt.bin"));
+}
+
+int main() {
+	test_read_edge_list();
+	test_binary_round_trip();
+	test_corrupt_binary();
+	return CHECK_RESULT();
+}
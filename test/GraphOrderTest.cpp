@@ -0,0 +1,107 @@
+// Orderings of GraphOrder.h: each must be a permutation, relabel must carry edges and
+// weights over with sorted neighbour lists, and restore_order must map per-vertex
+// results of the relabelled graph back onto the original vertices.
+
+#include "../GraphAlgebra.h"
+#include "../GraphOrder.h"
+#include "Check.h"
+#include <cmath>
+#include <functional>
+#include <random>
+
+// A few dense clusters joined by sparse random edges, some isolated vertices and a
+// handful of hubs, so every ordering has something to reorder.
+static Csr_Graph<uint32_t> test_graph() {
+	const uint32_t NODES = 3000;
+	mt19937 random(11);
+	vector<Edge<uint32_t> > edges;
+	for (uint32_t node = 0; node < NODES - 50; node++) {
+		edges.emplace_back(node, (node / 100 * 100 + random() % 100) % (NODES - 50), 1.0 + random() % 9);
+		if (node % 10 == 0)
+			edges.emplace_back(node, random() % (NODES - 50), 0.5);
+		if (node % 97 == 0)
+			for (uint32_t spoke = 0; spoke < 40; spoke++)
+				edges.emplace_back(node, random() % (NODES - 50), 2.0);
+	}
+	Graph<uint32_t> graph;
+	graph.build_from_edge_list(edges);
+	for (uint32_t node = NODES - 50; node < NODES; node++)
+		graph.insert_node(node);
+	return graph.to_csr();
+}
+
+static bool is_permutation_of_nodes(const vector<uint32_t>& rank, size_t nodes) {
+	vector<char> seen(nodes, false);
+	for (uint32_t index : rank) {
+		if (index >= nodes or seen[index])
+			return false;
+		seen[index] = true;
+	}
+	return rank.size() == nodes;
+}
+
+static bool relabelled(const Csr_Graph<uint32_t>& original, const Csr_Graph<uint32_t>& result, const vector<uint32_t>& rank) {
+	if (result.node_count() != original.node_count() or result.edge_count() != original.edge_count())
+		return false;
+	for (uint32_t node = 0; node < original.node_count(); node++) {
+		uint32_t moved = rank[node];
+		if (result.nodes()[moved] != original.nodes()[node] or result.degree(moved) != original.degree(node))
+			return false;
+
+		vector<pair<uint32_t, double> > expected;
+		for (uint64_t edge = original.offsets()[node]; edge < original.offsets()[node + 1]; edge++)
+			expected.emplace_back(rank[original.targets()[edge]], original.weights()[edge]);
+		sort(expected.begin(), expected.end());
+		for (size_t i = 0; i < expected.size(); i++) {
+			uint64_t edge = result.offsets()[moved] + i;
+			if (result.targets()[edge] != expected[i].first or result.weights()[edge] != expected[i].second)
+				return false;
+		}
+	}
+	return true;
+}
+
+static void test_orderings() {
+	Csr_Graph<uint32_t> csr = test_graph();
+	vector<double> rank_original = pagerank(csr);
+	vector<pair<const char*, function<vector<uint32_t>(const Csr_Graph<uint32_t>&)> > > orderings = {
+		{ "degree", [](const Csr_Graph<uint32_t>& graph) { return degree_order(graph, false); } },
+		{ "hub sort", [](const Csr_Graph<uint32_t>& graph) { return degree_order(graph, true); } },
+		{ "rcm", [](const Csr_Graph<uint32_t>& graph) { return reverse_cuthill_mckee(graph); } },
+		{ "gorder", [](const Csr_Graph<uint32_t>& graph) { return gorder(graph); } },
+	};
+
+	for (auto& [name, ordering] : orderings) {
+		vector<uint32_t> rank = ordering(csr);
+		bool permutation = is_permutation_of_nodes(rank, csr.node_count());
+		CHECK(permutation);
+		if (!permutation) {
+			fprintf(stderr, "  ordering: %s\n", name);
+			continue;
+		}
+
+		Csr_Graph<uint32_t> result = relabel(csr, rank);
+		CHECK(relabelled(csr, result, rank));
+
+		vector<double> restored = restore_order(pagerank(result), rank);
+		double difference = 0;
+		for (size_t node = 0; node < csr.node_count(); node++)
+			difference = max(difference, fabs(restored[node] - rank_original[node]));
+		CHECK(difference < 1e-9);
+	}
+}
+
+static void test_small_cases() {
+	Csr_Graph<uint32_t> empty;
+	CHECK(degree_order(empty).empty() && reverse_cuthill_mckee(empty).empty() && gorder(empty).empty());
+
+	vector<uint32_t> rank = { 2, 0, 1 };
+	CHECK(invert_order(invert_order(rank)) == rank);
+	CHECK((restore_order(vector<int>{ 10, 20, 30 }, rank) == vector<int>{ 30, 10, 20 }));
+}
+
+int main() {
+	test_orderings();
+	test_small_cases();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,78 @@
+// Batch insertion of Graph: the Insert_Summary counts and how repeated, reversed,
+// self looping and dangling edges of a batch are resolved.
+
+#include "../Graph.h"
+#include "Check.h"
+
+static void test_insert_summary() {
+	Graph<int> graph;
+	for (int node = 0; node < 4; node++)
+		graph.insert_node(node);
+	graph.insert_edge(Edge<int>(0, 1, 7.0));
+
+	vector<Edge<int> > batch = {
+		Edge<int>(1, 2, 1.0),
+		Edge<int>(2, 1, 9.0),
+		Edge<int>(1, 2, 8.0),
+		Edge<int>(1, 0, 3.0),
+		Edge<int>(2, 5, 1.0),
+		Edge<int>(6, 7, 1.0),
+		Edge<int>(3, 3, 4.0),
+	};
+	Insert_Summary summary = graph.insert_edges(batch);
+	CHECK(summary.inserted == 2);
+	CHECK(summary.duplicates == 2);
+	CHECK(summary.existing == 1);
+	CHECK(summary.missing == 2);
+	CHECK(summary.created_nodes == 0);
+
+	Csr_Graph<int> csr = graph.to_csr();
+	CHECK(csr.node_count() == 4);
+	CHECK(csr.edge_count() == 5);
+	CHECK(graph.has_edge(1, 2) && graph.has_edge(2, 1) && graph.has_edge(3, 3));
+	CHECK(csr.degree(csr.index_of(3)) == 1);
+	CHECK(!graph.has_edge(2, 3));
+
+	// First occurrence wins, in both directions; the existing edge keeps its weight.
+	uint32_t one = csr.index_of(1);
+	for (uint64_t edge = csr.offsets()[one]; edge < csr.offsets()[one + 1]; edge++) {
+		int neighbour = csr.nodes()[csr.targets()[edge]];
+		CHECK(csr.weights()[edge] == (neighbour == 0 ? 7.0 : 1.0));
+	}
+	uint32_t two = csr.index_of(2);
+	CHECK(csr.weights()[csr.offsets()[two]] == 1.0);
+}
+
+static void test_create_nodes() {
+	Graph<int> graph;
+	graph.insert_node(1);
+	vector<Edge<int> > batch = { Edge<int>(1, 2), Edge<int>(3, 4), Edge<int>(5, 5), Edge<int>(4, 3) };
+
+	Graph<int> unchanged = graph;
+	Insert_Summary summary = unchanged.insert_edges(batch, false);
+	CHECK(summary.missing == 3 && summary.duplicates == 1 && summary.created_nodes == 0);
+	CHECK(unchanged.to_csr().node_count() == 1);
+
+	summary = graph.insert_edges(batch, true);
+	CHECK(summary.inserted == 3 && summary.duplicates == 1 && summary.created_nodes == 4);
+	CHECK(graph.to_csr().node_count() == 5);
+	CHECK(graph.to_csr().edge_count() == 5);
+	CHECK(graph.has_edge(4, 3) && graph.has_edge(5, 5));
+}
+
+static void test_build_from_edge_list() {
+	Graph<int> graph;
+	graph.insert_node(42);
+	Insert_Summary summary = graph.build_from_edge_list(vector<Edge<int> >{ Edge<int>(1, 2), Edge<int>(2, 3), Edge<int>(3, 2) });
+	CHECK(summary.inserted == 2 && summary.duplicates == 1 && summary.created_nodes == 3);
+	CHECK(graph.to_csr().node_count() == 3);
+	CHECK_THROWS(graph.has_edge(42, 1));
+	CHECK(graph.total_components() == 1);
+}
+
+int main() {
+	test_insert_summary();
+	test_create_nodes();
+	test_build_from_edge_list();
+	return CHECK_RESULT();
+}
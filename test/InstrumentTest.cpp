@@ -0,0 +1,88 @@
+// Counters of Instrument.h, compiled in regardless of the CPPLIB_INSTRUMENT option.
+// Graph entry points must count the same searches whether they succeed or throw.
+
+#ifndef CPPLIB_INSTRUMENT
+#define CPPLIB_INSTRUMENT
+#endif
+
+#include "../Graph.h"
+#include "../Matrix.h"
+#include "../Vector.h"
+#include "Check.h"
+#include <sstream>
+
+static uint64_t lookups_of(void (*call)(Graph<int>&), Graph<int>& graph) {
+	uint64_t before = instrument::snapshot().graph_lookups;
+	try { call(graph); } catch (const exception&) {}
+	return instrument::snapshot().graph_lookups - before;
+}
+
+static void test_graph_lookups() {
+	Graph<int> graph;
+	for (int node = 0; node < 3; node++)
+		graph.insert_node(node);
+	graph.insert_edge(Edge<int>(0, 1));
+
+	// Missing first endpoint: the second is never searched for.
+	CHECK(lookups_of([](Graph<int>& g) { g.insert_edge(Edge<int>(9, 0)); }, graph) == 1);
+	CHECK(lookups_of([](Graph<int>& g) { g.remove_edge(Edge<int>(9, 0)); }, graph) == 1);
+	CHECK(lookups_of([](Graph<int>& g) { g.change_weight(Edge<int>(9, 0), 2.0); }, graph) == 1);
+	CHECK(lookups_of([](Graph<int>& g) { (void)g.has_edge(9, 0); }, graph) == 1);
+	CHECK(lookups_of([](Graph<int>& g) { (void)g.has_connection(9, 0); }, graph) == 1);
+
+	// Missing second endpoint: only the two validating searches.
+	CHECK(lookups_of([](Graph<int>& g) { g.insert_edge(Edge<int>(0, 9)); }, graph) == 2);
+	CHECK(lookups_of([](Graph<int>& g) { g.remove_edge(Edge<int>(0, 9)); }, graph) == 2);
+	CHECK(lookups_of([](Graph<int>& g) { g.change_weight(Edge<int>(0, 9), 2.0); }, graph) == 2);
+	CHECK(lookups_of([](Graph<int>& g) { (void)g.has_edge(0, 9); }, graph) == 2);
+	CHECK(lookups_of([](Graph<int>& g) { (void)g.has_connection(0, 9); }, graph) == 2);
+	CHECK(lookups_of([](Graph<int>& g) { g.remove_node(9); }, graph) == 1);
+	CHECK(lookups_of([](Graph<int>& g) { g.insert_node(0); }, graph) == 1);
+
+	// Present endpoints, failing edge check: four validating searches.
+	CHECK(lookups_of([](Graph<int>& g) { g.insert_edge(Edge<int>(0, 1)); }, graph) == 4);
+	CHECK(lookups_of([](Graph<int>& g) { g.remove_edge(Edge<int>(0, 2)); }, graph) == 4);
+
+	// Successful calls.
+	CHECK(lookups_of([](Graph<int>& g) { g.insert_edge(Edge<int>(1, 2)); }, graph) == 8);
+	CHECK(lookups_of([](Graph<int>& g) { g.change_weight(Edge<int>(1, 2), 2.0); }, graph) == 8);
+	CHECK(lookups_of([](Graph<int>& g) { (void)g.has_edge(1, 2); }, graph) == 4);
+	CHECK(lookups_of([](Graph<int>& g) { g.remove_edge(Edge<int>(1, 2)); }, graph) == 8);
+}
+
+static void test_containers() {
+	instrument::reset();
+	Vector<int> vector;
+	for (int i = 0; i < 100; i++)
+		vector.push_back(i);
+	instrument::Counters counters = instrument::snapshot();
+	CHECK(counters.allocations >= 1 && counters.reallocations >= 1);
+	CHECK(counters.element_copies + counters.element_moves >= 100);
+
+	instrument::reset();
+	Matrix<double> first(4, 5, 1.0), second(5, 3, 1.0);
+	Matrix<double> product = first * second;
+	CHECK(instrument::snapshot().matrix_flops == 2 * 4 * 5 * 3);
+	CHECK(instrument::local_timers().at("Matrix::operator*").calls == 1);
+
+	std::ostringstream json;
+	instrument::dump_json(json);
+	CHECK(json.str().find("\"matrix_flops\": 120") != string::npos);
+
+	// Assignment reallocates like construction: one buffer per row plus the row array.
+	instrument::reset();
+	product = first;
+	counters = instrument::snapshot();
+	CHECK(counters.allocations == 5);
+	CHECK(counters.bytes_allocated == 4 * (5 * sizeof(double) + sizeof(std::vector<double>)));
+	CHECK(counters.element_copies == 20);
+	instrument::reset();
+	product = std::vector<std::vector<double> >(2, std::vector<double>(3, 0.0));
+	CHECK(instrument::snapshot().allocations == 3 && instrument::snapshot().element_copies == 6);
+}
+
+int main() {
+	test_graph_lookups();
+	test_containers();
+	return CHECK_RESULT();
+}
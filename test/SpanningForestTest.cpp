@@ -0,0 +1,81 @@
+// Kruskal and Boruvka on hand-checked small graphs and on a random graph with enough
+// edges (more than 2 * PARALLEL_THRESHOLD) for Boruvka's parallel rounds to run on
+// multicore hosts. Weights are drawn from a small range so ties are common.
+
+#include "../Graph.h"
+#include "Check.h"
+#include <random>
+
+static size_t node_count(const Graph<uint32_t>& graph) { return graph.to_csr().node_count(); }
+
+// True when the forest edges exist in the graph, form no cycle and join exactly the
+// vertices the graph joins, i.e. there are V - components of them.
+static bool spans(const Graph<uint32_t>& graph, const Spanning_Forest<uint32_t>& forest) {
+	Csr_Graph<uint32_t> csr = graph.to_csr();
+	vector<uint32_t> parent(csr.node_count());
+	iota(parent.begin(), parent.end(), 0);
+	auto root = [&parent](uint32_t node) {
+		while (parent[node] != node)
+			node = parent[node] = parent[parent[node]];
+		return node;
+	};
+
+	double total = 0;
+	for (const Edge<uint32_t>& edge : forest.edges) {
+		if (!graph.has_edge(edge.getFirst(), edge.getSecond()))
+			return false;
+		uint32_t first = root(csr.index_of(edge.getFirst())), second = root(csr.index_of(edge.getSecond()));
+		if (first == second)
+			return false;
+		parent[first] = second;
+		total += edge.getWeight();
+	}
+	return forest.edges.size() == csr.node_count() - graph.total_components() and total == forest.total_weight;
+}
+
+static void test_small_graphs() {
+	// Two components, a self loop, a parallel cheaper path and tied weights.
+	Graph<uint32_t> graph;
+	graph.build_from_edge_list(vector<Edge<uint32_t> >{
+		Edge<uint32_t>(0, 1, 4), Edge<uint32_t>(1, 2, 1), Edge<uint32_t>(0, 2, 2), Edge<uint32_t>(2, 2, 0),
+		Edge<uint32_t>(2, 3, 2), Edge<uint32_t>(3, 0, 2),
+		Edge<uint32_t>(10, 11, 5), Edge<uint32_t>(11, 12, 5), Edge<uint32_t>(12, 10, 5),
+	});
+	graph.insert_node(20);
+
+	for (const Spanning_Forest<uint32_t>& forest : { graph.kruskal(), graph.boruvka(), graph.minimum_spanning_forest() }) {
+		CHECK(forest.total_weight == 1 + 2 + 2 + 5 + 5);
+		CHECK(forest.edges.size() == 5);
+		CHECK(spans(graph, forest));
+	}
+
+	Graph<uint32_t> empty;
+	CHECK(empty.kruskal().edges.empty() && empty.boruvka().edges.empty());
+}
+
+static void test_random_graph() {
+	const uint32_t NODES = 60000;
+	const size_t EDGES = 200000;
+	mt19937 random(7);
+	vector<Edge<uint32_t> > edges;
+	for (size_t edge = 0; edge < EDGES; edge++) {
+		uint32_t first = random() % NODES;
+		uint32_t second = edge % 50 == 0 ? first : random() % NODES;
+		edges.emplace_back(first, second, (double)(random() % 16));
+	}
+	Graph<uint32_t> graph;
+	graph.build_from_edge_list(edges);
+	CHECK(node_count(graph) > NODES / 2 && graph.total_components() > 1);
+
+	Spanning_Forest<uint32_t> kruskal = graph.kruskal(), boruvka = graph.boruvka();
+	CHECK(kruskal.total_weight == boruvka.total_weight);
+	CHECK(kruskal.edges.size() == boruvka.edges.size());
+	CHECK(spans(graph, kruskal));
+	CHECK(spans(graph, boruvka));
+}
+
+int main() {
+	test_small_graphs();
+	test_random_graph();
+	return CHECK_RESULT();
+}